@@ -0,0 +1,240 @@
+/**
+ * @author: Randolph Bushman
+ * @date: 10/19/2026
+ */
+#include "../sort_utils.h"
+#include "../sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    int* arr;  // The array being sorted
+    int* aux_arr;  // Auxiliary array of the lane
+    int* keys;  // Keys array of the lane
+    void* counting_arr;  // Counting array of the lane
+    size_t length;  // The length of arr
+} BatchLane;
+
+/**
+ * Performs Insertion Sort on the given array. Used by Batch Sort for arrays too small to amortize a counting pass.
+ * @param arr the array to be sorted
+ * @param arr_length the length of the array
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ */
+void insertion_sort(int arr[], const size_t arr_length, unsigned long long int* instruction_counter) {
+    for (size_t i = 1; i < arr_length; ++i) {
+        int x = arr[i];
+        ptrdiff_t j = (ptrdiff_t) i - 1;
+        *instruction_counter += 3;
+        while ((*instruction_counter += 2) && j >= 0 && arr[j] > x) {
+            *instruction_counter += 3;
+            arr[j + 1] = arr[j];
+            --j;
+        }
+        ++(*instruction_counter);
+        arr[j + 1] = x;
+    }
+}
+
+/**
+ * Performs counting key sort on the two arrays of a pair of lanes at once. The histogram and scatter loops of the two
+ * arrays are interleaved, so the dependent counter updates of one array overlap those of the other. Each lane must have
+ * 32-bit counters.
+ * @param lanes the two lanes to sort
+ * @param from_aux a flag indicating whether each lane's aux_arr is sorted into its arr (1) or its arr into its aux_arr (0)
+ * @param counting_arr_length the number of counters used in each lane's counting_arr
+ * @param move_aux a flag indicating whether to copy sorted elements back to each lane's arr (1: Yes, 0: No)
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ */
+void counting_key_sort_pair(const BatchLane lanes[2], const int from_aux, const size_t counting_arr_length, const int move_aux, unsigned long long int* instruction_counter) {
+    const int *source_a = from_aux ? lanes[0].aux_arr : lanes[0].arr, *source_b = from_aux ? lanes[1].aux_arr : lanes[1].arr;
+    int *target_a = from_aux ? lanes[0].arr : lanes[0].aux_arr, *target_b = from_aux ? lanes[1].arr : lanes[1].aux_arr;
+    const int *keys_a = lanes[0].keys, *keys_b = lanes[1].keys;
+    uint32_t *counting_a = lanes[0].counting_arr, *counting_b = lanes[1].counting_arr;
+    size_t length_a = lanes[0].length, length_b = lanes[1].length;
+    size_t shared_length = (length_a < length_b) ? length_a : length_b;
+
+    *instruction_counter += 2 * (HISTOGRAM_INSTRUCTION_WEIGHT * shared_length + 1);
+    *instruction_counter += HISTOGRAM_INSTRUCTION_WEIGHT * (length_a + length_b - 2 * shared_length);
+    *instruction_counter += 2 * PREFIX_SUM_INSTRUCTION_WEIGHT * counting_arr_length;
+    *instruction_counter += SCATTER_INSTRUCTION_WEIGHT * (length_a + length_b) + 2;
+
+    // Count occurrences using keys
+    for (size_t i = 0; i < shared_length; ++i) {
+        counting_a[keys_a[i]]++;
+        counting_b[keys_b[i]]++;
+    }
+    for (size_t i = shared_length; i < length_a; ++i)
+        counting_a[keys_a[i]]++;
+    for (size_t i = shared_length; i < length_b; ++i)
+        counting_b[keys_b[i]]++;
+
+    // Accumulate counts
+    for (size_t i = 1; i < counting_arr_length; ++i) {
+        counting_a[i] += counting_a[i - 1];
+        counting_b[i] += counting_b[i - 1];
+    }
+
+    // Rearrange elements, walking each array from its end to keep the sort stable
+    for (size_t i = length_a; i-- > shared_length;)
+        target_a[--counting_a[keys_a[i]]] = source_a[i];
+    for (size_t i = length_b; i-- > shared_length;)
+        target_b[--counting_b[keys_b[i]]] = source_b[i];
+    for (size_t i = shared_length; i-- > 0;) {
+        target_a[--counting_a[keys_a[i]]] = source_a[i];
+        target_b[--counting_b[keys_b[i]]] = source_b[i];
+    }
+
+    // Copy back to original arrays
+    if (move_aux) {
+        *instruction_counter += COPY_INSTRUCTION_WEIGHT * (length_a + length_b) + 2;
+        for (int l = 0; l < 2; ++l)
+            for (size_t i = 0; i < lanes[l].length; ++i)
+                lanes[l].arr[i] = lanes[l].aux_arr[i];
+    }
+}
+
+/**
+ * QR Sorts the arrays of one lane, or of two lanes with their counting passes interleaved.
+ * @param lanes the lanes to sort; each lane's counting_arr must be zeroed, and is zeroed again on return
+ * @param lane_count the number of lanes to sort; 2 requires 32-bit counters
+ * @param counter_size the size of each counter in the lanes' counting arrays in bytes, as given by COUNTER_SIZE
+ * @param min_value the minimum value in the batch
+ * @param max_quotient the number of quotient buckets
+ * @param args additional sorting arguments; args.divisor must be a positive int
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ */
+void batch_counting_passes(const BatchLane lanes[], const int lane_count, const size_t counter_size, const int min_value, const int max_quotient, const SortArgs args, unsigned long long int* instruction_counter) {
+    int divisor = args.divisor;
+    for (int l = 0; l < lane_count; ++l)
+        compute_remainder_keys(lanes[l].arr, lanes[l].keys, lanes[l].length, min_value, max_quotient, args, instruction_counter);
+    if (lane_count == 2)
+        counting_key_sort_pair(lanes, 0, divisor, max_quotient == 1, instruction_counter);
+    else
+        counting_key_sort(lanes[0].arr, lanes[0].aux_arr, lanes[0].keys, lanes[0].counting_arr, counter_size, lanes[0].length, divisor, max_quotient == 1, instruction_counter);
+
+    for (int l = 0; l < lane_count; ++l) {
+        *instruction_counter += RESET_INSTRUCTION_WEIGHT * divisor + 1;
+        reset_counters(lanes[l].counting_arr, counter_size, divisor);  // Reset Counting Array
+    }
+
+    if (max_quotient > 1) {
+        for (int l = 0; l < lane_count; ++l)
+            compute_quotient_keys(lanes[l].aux_arr, lanes[l].keys, lanes[l].length, min_value, args, instruction_counter);
+        if (lane_count == 2)
+            counting_key_sort_pair(lanes, 1, max_quotient, 0, instruction_counter);
+        else
+            counting_key_sort(lanes[0].aux_arr, lanes[0].arr, lanes[0].keys, lanes[0].counting_arr, counter_size, lanes[0].length, max_quotient, 0, instruction_counter);
+
+        for (int l = 0; l < lane_count; ++l) {
+            *instruction_counter += RESET_INSTRUCTION_WEIGHT * max_quotient + 1;
+            reset_counters(lanes[l].counting_arr, counter_size, max_quotient);  // Reset Counting Array
+        }
+    }
+}
+
+/**
+ * Performs QR Sort on many independent arrays stored back to back in a single buffer. The min/max scan, divisor
+ * computation, and buffer allocations are done once for the whole batch rather than once per array. Each array is sorted
+ * by whichever of Insertion Sort, Quicksort, or QR Sort's counting passes is modeled as cheapest for its length, and
+ * arrays sorted by the counting passes are sorted in pairs with their passes interleaved.
+ * @param arr the flat buffer holding every array to be sorted
+ * @param offsets array i occupies arr[offsets[i]] to arr[offsets[i + 1] - 1]; has num_arrays + 1 entries
+ * @param num_arrays the number of arrays in the batch
+ * @param args additional sorting arguments
+ * @return the total number of instructions executed during the sort
+ */
+unsigned long long int batch_sort(int arr[], const size_t offsets[], const size_t num_arrays, SortArgs args) {
+    unsigned long long int instruction_counter = 0;
+    size_t total_length = offsets[num_arrays] - offsets[0];
+    if (num_arrays < 1 || total_length < 1)
+        return instruction_counter;
+    arr += offsets[0];
+
+    // A single min/max scan over the whole batch shares one divisor and one counting array between all arrays
+    int min_value = 0, max_value = 0;
+    if (args.min_value_zero)
+        find_max(arr, total_length, &max_value, &instruction_counter);
+    else
+        find_min_max(arr, total_length, &min_value, &max_value, &instruction_counter);
+
+    // If divisor is not a positive int, use the smallest power of 2 that is at least sqrt(max_value - min_value + 1)
+    if (args.divisor <= 0) {
+        args.divisor = 1;
+        while ((long long int) args.divisor * args.divisor < (long long int) max_value - min_value + 1)
+            args.divisor <<= 1;
+        args.bitwise_ops = 1;
+    }
+    int divisor = args.divisor;
+
+    int max_quotient = ((max_value - min_value) / divisor) + 1;
+    instruction_counter += DIVISION_INSTRUCTION_WEIGHT;
+
+    // Auxiliary and keys arrays are reused by every array, so they only need to fit the longest one
+    size_t max_arr_length = 0;
+    for (size_t a = 0; a < num_arrays; ++a)
+        if (offsets[a + 1] - offsets[a] > max_arr_length)
+            max_arr_length = offsets[a + 1] - offsets[a];
+    instruction_counter += 4 * num_arrays + 1;
+
+    // Each lane holds the buffers of one array in an interleaved pair; pairs need 32-bit counters
+    size_t counter_size = COUNTER_SIZE(max_arr_length);
+    size_t counter_count = divisor > max_quotient ? divisor : max_quotient;
+    int lane_capacity = (counter_size == sizeof(uint32_t)) ? 2 : 1;
+    int* aux_arr = huge_malloc(lane_capacity * max_arr_length * sizeof(int));
+    char* counting_arr = huge_calloc(lane_capacity * counter_count, counter_size);
+    int* keys = huge_malloc(lane_capacity * max_arr_length * sizeof(int));
+    if (aux_arr == NULL || counting_arr == NULL || keys == NULL) {
+        perror("Batch Sort could not allocate its buffers");
+        free(aux_arr);
+        free(counting_arr);
+        free(keys);
+        return SORT_ALLOCATION_FAILED;
+    }
+    BatchLane lanes[2];
+    for (int l = 0; l < lane_capacity; ++l) {
+        lanes[l].aux_arr = aux_arr + l * max_arr_length;
+        lanes[l].keys = keys + l * max_arr_length;
+        lanes[l].counting_arr = counting_arr + l * counter_count * counter_size;
+    }
+
+    // Modeled cost per array: Insertion Sort averages 5n^2/4 and Quicksort about 6n log2(n) on random input, while
+    // the two counting passes cost 2 * (key_cost + element_cost) * n plus a prefix sum and reset per counter
+    unsigned long long int key_cost = args.bitwise_ops ? SHIFT_KEY_INSTRUCTION_WEIGHT : KEY_INSTRUCTION_WEIGHT + DIVISION_INSTRUCTION_WEIGHT;
+    unsigned long long int element_cost = HISTOGRAM_INSTRUCTION_WEIGHT + SCATTER_INSTRUCTION_WEIGHT;
+    unsigned long long int per_counter_cost = PREFIX_SUM_INSTRUCTION_WEIGHT + RESET_INSTRUCTION_WEIGHT;
+    unsigned long long int counter_cost = per_counter_cost * divisor + (max_quotient > 1 ? per_counter_cost * max_quotient : 0);
+
+    int lane_count = 0;
+    for (size_t a = 0; a < num_arrays; ++a) {
+        size_t start = offsets[a] - offsets[0];
+        size_t arr_length = offsets[a + 1] - offsets[a];
+
+        unsigned long long int log_length = 0;
+        while ((1ULL << log_length) < arr_length)
+            ++log_length;
+        unsigned long long int insertion_cost = 5ULL * arr_length * arr_length / 4;
+        unsigned long long int quicksort_cost = 6ULL * arr_length * log_length;
+        unsigned long long int counting_cost = 2 * (key_cost + element_cost) * arr_length + counter_cost;
+
+        if (insertion_cost <= quicksort_cost && insertion_cost <= counting_cost)
+            insertion_sort(arr + start, arr_length, &instruction_counter);
+        else if (quicksort_cost < counting_cost)
+            instruction_counter += quicksort(arr + start, arr_length, args);
+        else {
+            lanes[lane_count].arr = arr + start;
+            lanes[lane_count++].length = arr_length;
+            if (lane_count == lane_capacity) {
+                batch_counting_passes(lanes, lane_count, counter_size, min_value, max_quotient, args, &instruction_counter);
+                lane_count = 0;
+            }
+        }
+    }
+    if (lane_count > 0)
+        batch_counting_passes(lanes, lane_count, counter_size, min_value, max_quotient, args, &instruction_counter);
+
+    free(aux_arr);
+    free(counting_arr);
+    free(keys);
+    return instruction_counter;
+}
@@ -4,40 +4,72 @@
  */
 #include "../sort_utils.h"
 #include "../sort.h"
+#include <stdio.h>
 #include <stdlib.h>
 
+/**
+ * Counts, accumulates, and scatters arr by keys with 32-bit counters. Used by counting_key_sort.
+ * @param arr the array of integers to be sorted
+ * @param aux_arr the scatter destination
+ * @param keys an array of keys corresponding to the elements in arr
+ * @param counting_arr a zeroed array of 32-bit counters
+ * @param arr_length the length of arr, aux_arr, and keys; at most UINT32_MAX
+ * @param counting_arr_length The length of counting_arr
+ */
+void counting_key_scatter_32(const int arr[], int aux_arr[], const int keys[], uint32_t counting_arr[], const size_t arr_length, const size_t counting_arr_length) {
+    for (size_t i = 0; i < arr_length; ++i)
+        counting_arr[keys[i]]++;
+    for (size_t i = 1; i < counting_arr_length; ++i)
+        counting_arr[i] += counting_arr[i - 1];
+    for (size_t i = arr_length; i-- > 0;)
+        aux_arr[--counting_arr[keys[i]]] = arr[i];
+}
+
+/**
+ * Counts, accumulates, and scatters arr by keys with size_t counters. Used by counting_key_sort.
+ * @param arr the array of integers to be sorted
+ * @param aux_arr the scatter destination
+ * @param keys an array of keys corresponding to the elements in arr
+ * @param counting_arr a zeroed array of size_t counters
+ * @param arr_length the length of arr, aux_arr, and keys
+ * @param counting_arr_length The length of counting_arr
+ */
+void counting_key_scatter_64(const int arr[], int aux_arr[], const int keys[], size_t counting_arr[], const size_t arr_length, const size_t counting_arr_length) {
+    for (size_t i = 0; i < arr_length; ++i)
+        counting_arr[keys[i]]++;
+    for (size_t i = 1; i < counting_arr_length; ++i)
+        counting_arr[i] += counting_arr[i - 1];
+    for (size_t i = arr_length; i-- > 0;)
+        aux_arr[--counting_arr[keys[i]]] = arr[i];
+}
+
 /**
  * Performs counting key sort on the given array.
  * @param arr the array of integers to be sorted
  * @param aux_arr an auxiliary array used for sorting
  * @param keys an array of keys corresponding to the elements in arr
  * @param counting_arr an array used for counting occurrences of each key
+ * @param counter_size the size of each counter in counting_arr in bytes, as given by COUNTER_SIZE
  * @param arr_length the length of arr, aux_arr, and keys
  * @param counting_arr_length The length of counting_arr
  * @param move_aux a flag indicating whether to copy sorted elements back to arr (1: Yes, 0: No).
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void counting_key_sort(int arr[], int aux_arr[], const int keys[], int counting_arr[], const int arr_length, const int counting_arr_length, const int move_aux, unsigned long long int* instruction_counter) {
-    *instruction_counter += 3 * arr_length + 1;
-    *instruction_counter += 3 * counting_arr_length;
-    *instruction_counter += 5 * arr_length + 1;
+void counting_key_sort(int arr[], int aux_arr[], const int keys[], void *counting_arr, const size_t counter_size, const size_t arr_length, const size_t counting_arr_length, const int move_aux, unsigned long long int* instruction_counter) {
+    *instruction_counter += HISTOGRAM_INSTRUCTION_WEIGHT * arr_length + 1;
+    *instruction_counter += PREFIX_SUM_INSTRUCTION_WEIGHT * counting_arr_length;
+    *instruction_counter += SCATTER_INSTRUCTION_WEIGHT * arr_length + 1;
 
-    // Count occurrences using keys
-    for (int i = 0; i < arr_length; ++i)
-        counting_arr[keys[i]]++;
-
-    // Accumulate counts
-    for (int i = 1; i < counting_arr_length; ++i)
-        counting_arr[i] += counting_arr[i - 1];
-
-    // Rearrange elements
-    for (int i = arr_length - 1; i > -1; --i)
-        aux_arr[--counting_arr[keys[i]]] = arr[i];
+    // Count occurrences using keys, accumulate counts, and rearrange elements
+    if (counter_size == sizeof(uint32_t))
+        counting_key_scatter_32(arr, aux_arr, keys, counting_arr, arr_length, counting_arr_length);
+    else
+        counting_key_scatter_64(arr, aux_arr, keys, counting_arr, arr_length, counting_arr_length);
 
     // Copy back to original array
     if (move_aux) {
-        *instruction_counter += 3 * arr_length + 1;
-        for (int i = 0; i < arr_length; ++i)
+        *instruction_counter += COPY_INSTRUCTION_WEIGHT * arr_length + 1;
+        for (size_t i = 0; i < arr_length; ++i)
             arr[i] = aux_arr[i];
     }
 }
@@ -49,7 +81,7 @@ void counting_key_sort(int arr[], int aux_arr[], const int keys[], int counting_
  * @param args additional sorting arguments (not used in this implementation)
  * @return the total number of instructions executed during the sort
  */
-unsigned long long int counting_sort(int arr[], const int arr_length, const SortArgs args) {
+unsigned long long int counting_sort(int arr[], const size_t arr_length, const SortArgs args) {
     unsigned long long int instruction_counter = 0;  // # of comparisons + array accesses
 
     // Find minimum and maximum array values
@@ -61,11 +93,19 @@ unsigned long long int counting_sort(int arr[], const int arr_length, const Sort
         find_min_max(arr, arr_length, &min_value, &max_value, &instruction_counter);
 
     // Auxiliary and keys array
-    int* aux_arr = malloc(arr_length * sizeof(int));
-    int* counting_arr = calloc((max_value - min_value + 1), sizeof(int));
+    size_t value_range = (size_t) ((long long int) max_value - min_value + 1);
+    size_t counter_size = COUNTER_SIZE(arr_length);
+    int* aux_arr = huge_malloc(arr_length * sizeof(int));
+    void* counting_arr = huge_calloc(value_range, counter_size);
+    if (aux_arr == NULL || counting_arr == NULL) {
+        perror("Counting Sort could not allocate its buffers");
+        free(aux_arr);
+        free(counting_arr);
+        return SORT_ALLOCATION_FAILED;
+    }
 
     // Call the modified counting_key_sort function
-    counting_key_sort(arr, aux_arr, arr, counting_arr, arr_length, (max_value - min_value + 1), 1, &instruction_counter);
+    counting_key_sort(arr, aux_arr, arr, counting_arr, counter_size, arr_length, value_range, 1, &instruction_counter);
 
     free(aux_arr);
     free(counting_arr);
@@ -3,6 +3,7 @@
  * @date: 01/12/2024
  */
 #include "../sort.h"
+#include <stdio.h>
 #include <stdlib.h>
 
 /**
@@ -14,8 +15,8 @@
  * @param end_idx The ending index of the second segment
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void merge(int arr[], int aux_arr[], const int start_idx, const int mid_idx, const int end_idx, unsigned long long int* instruction_counter) {
-    int i = start_idx, j = mid_idx + 1, k = start_idx;
+void merge(int arr[], int aux_arr[], const ptrdiff_t start_idx, const ptrdiff_t mid_idx, const ptrdiff_t end_idx, unsigned long long int* instruction_counter) {
+    ptrdiff_t i = start_idx, j = mid_idx + 1, k = start_idx;
 
     while ((++(*instruction_counter) && i <= mid_idx) && (++(*instruction_counter) && j <= end_idx)) {
         *instruction_counter += 5;
@@ -36,7 +37,7 @@ void merge(int arr[], int aux_arr[], const int start_idx, const int mid_idx, con
     while (j <= end_idx)
         aux_arr[k++] = arr[j++];
 
-    for (int x = start_idx; x <= end_idx; x++)
+    for (ptrdiff_t x = start_idx; x <= end_idx; x++)
         arr[x] = aux_arr[x];
 }
 
@@ -48,9 +49,9 @@ void merge(int arr[], int aux_arr[], const int start_idx, const int mid_idx, con
  * @param end_idx the end index where merge sort is performed on arr
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void merge_sort_recursive(int arr[], int aux_arr[], const int start_idx, const int end_idx, unsigned long long int* instruction_counter) {
+void merge_sort_recursive(int arr[], int aux_arr[], const ptrdiff_t start_idx, const ptrdiff_t end_idx, unsigned long long int* instruction_counter) {
     if (++(*instruction_counter) && start_idx < end_idx) {
-        int mid = (start_idx + end_idx) >> 1;
+        ptrdiff_t mid = (start_idx + end_idx) >> 1;
         merge_sort_recursive(arr, aux_arr, start_idx, mid, instruction_counter);
         merge_sort_recursive(arr, aux_arr, mid + 1, end_idx, instruction_counter);
         merge(arr, aux_arr, start_idx, mid, end_idx, instruction_counter);
@@ -64,10 +65,14 @@ void merge_sort_recursive(int arr[], int aux_arr[], const int start_idx, const i
  * @param args additional sorting arguments (not used in this implementation)
  * @return the total number of instructions executed during the sort
  */
-unsigned long long int merge_sort(int arr[], const int arr_length, const SortArgs args) {
+unsigned long long int merge_sort(int arr[], const size_t arr_length, const SortArgs args) {
     unsigned long long int instruction_counter = 0;  // # of comparisons + array accesses
-    int *aux_array = malloc(arr_length * sizeof (int));
-    merge_sort_recursive(arr, aux_array, 0, arr_length - 1, &instruction_counter);
+    int *aux_array = huge_malloc(arr_length * sizeof (int));
+    if (aux_array == NULL) {
+        perror("Merge Sort could not allocate its buffer");
+        return SORT_ALLOCATION_FAILED;
+    }
+    merge_sort_recursive(arr, aux_array, 0, (ptrdiff_t) arr_length - 1, &instruction_counter);
     free(aux_array);
     return instruction_counter;
 }
@@ -0,0 +1,107 @@
+/**
+ * @author: Randolph Bushman
+ * @date: 10/19/2026
+ */
+#include "../sort_utils.h"
+#include "../sort.h"
+#include <stdlib.h>
+
+/**
+ * Groups the elements of arr by quotient key in a single counting pass and finds the quotient bucket holding the
+ * element of the given rank. Elements in lower buckets are smaller and elements in higher buckets are larger than every
+ * element of that bucket.
+ * @param arr the array to be grouped; grouped in place
+ * @param aux_arr an auxiliary array used for grouping
+ * @param keys an array used to store the quotient keys
+ * @param counting_arr a zeroed counting array of at least max_quotient elements; zeroed again on return
+ * @param counter_size the size of each counter in counting_arr in bytes, as given by COUNTER_SIZE
+ * @param arr_length the length of arr, aux_arr, and keys
+ * @param min_value the minimum value in arr
+ * @param max_quotient the number of quotient buckets
+ * @param rank_idx the 0-based rank of the element to locate
+ * @param args additional sorting arguments
+ * @param bucket pointer to store the quotient of the located bucket
+ * @param bucket_start pointer to store the index of the first element in the located bucket
+ * @param bucket_end pointer to store the index one past the last element in the located bucket
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ */
+void find_quotient_bucket(int arr[], int aux_arr[], int keys[], void *counting_arr, const size_t counter_size, const size_t arr_length, const int min_value, const int max_quotient, const size_t rank_idx, const SortArgs args, int *bucket, size_t *bucket_start, size_t *bucket_end, unsigned long long int *instruction_counter) {
+    compute_quotient_keys(arr, keys, arr_length, min_value, args, instruction_counter);
+    counting_key_sort(arr, aux_arr, keys, counting_arr, counter_size, arr_length, max_quotient, 1, instruction_counter);
+
+    // After counting_key_sort, counting_arr[q] holds the index of the first element with quotient q
+    *bucket = 0;
+    while ((*instruction_counter += 3) && *bucket + 1 < max_quotient && read_counter(counting_arr, counter_size, *bucket + 1) <= rank_idx)
+        ++*bucket;
+    *bucket_start = read_counter(counting_arr, counter_size, *bucket);
+    *bucket_end = (*bucket + 1 < max_quotient) ? read_counter(counting_arr, counter_size, *bucket + 1) : arr_length;
+
+    *instruction_counter += RESET_INSTRUCTION_WEIGHT * max_quotient + 1;
+    reset_counters(counting_arr, counter_size, max_quotient);  // Reset Counting Array
+}
+
+/**
+ * Performs QR Select on the given array, placing the k-th smallest element at index k - 1 with all smaller elements
+ * before it and all larger elements after it. Only the quotient bucket containing rank k is sorted by remainder.
+ * @param arr the array to be partitioned
+ * @param arr_length the length of the array
+ * @param args additional sorting arguments; args.rank specifies k
+ * @return the total number of instructions executed during the selection
+ */
+unsigned long long int qr_select(int arr[], const size_t arr_length, SortArgs args) {
+    unsigned long long int instruction_counter = 0;
+    size_t rank_idx = ((args.rank > 0 && args.rank <= arr_length) ? args.rank : (arr_length + 1) / 2) - 1;
+
+    int min_value, max_quotient;
+    int *aux_arr, *keys;
+    void *counting_arr;
+    if (qr_sort_setup(arr, arr_length, &args, &min_value, &max_quotient, &aux_arr, &counting_arr, &keys, &instruction_counter))
+        return SORT_ALLOCATION_FAILED;
+    size_t counter_size = COUNTER_SIZE(arr_length);
+
+    int bucket;
+    size_t bucket_start, bucket_end;
+    find_quotient_bucket(arr, aux_arr, keys, counting_arr, counter_size, arr_length, min_value, max_quotient, rank_idx, args, &bucket, &bucket_start, &bucket_end, &instruction_counter);
+
+    // Every element in the bucket shares a quotient, so sorting it by remainder sorts it completely
+    compute_remainder_keys(arr + bucket_start, keys, bucket_end - bucket_start, min_value, max_quotient, args, &instruction_counter);
+    counting_key_sort(arr + bucket_start, aux_arr, keys, counting_arr, counter_size, bucket_end - bucket_start, args.divisor, 1, &instruction_counter);
+
+    free(aux_arr);
+    free(counting_arr);
+    free(keys);
+    return instruction_counter;
+}
+
+/**
+ * Performs QR Partial Sort on the given array, placing the k smallest elements in ascending order at the front of the
+ * array. The order of the remaining elements is unspecified. Only the quotient buckets up to and including the one
+ * containing rank k are sorted.
+ * @param arr the array to be partially sorted
+ * @param arr_length the length of the array
+ * @param args additional sorting arguments; args.rank specifies k
+ * @return the total number of instructions executed during the sort
+ */
+unsigned long long int qr_partial_sort(int arr[], const size_t arr_length, SortArgs args) {
+    unsigned long long int instruction_counter = 0;
+    size_t rank_idx = ((args.rank > 0 && args.rank <= arr_length) ? args.rank : (arr_length + 1) / 2) - 1;
+
+    int min_value, max_quotient;
+    int *aux_arr, *keys;
+    void *counting_arr;
+    if (qr_sort_setup(arr, arr_length, &args, &min_value, &max_quotient, &aux_arr, &counting_arr, &keys, &instruction_counter))
+        return SORT_ALLOCATION_FAILED;
+    size_t counter_size = COUNTER_SIZE(arr_length);
+
+    int bucket;
+    size_t bucket_start, bucket_end;
+    find_quotient_bucket(arr, aux_arr, keys, counting_arr, counter_size, arr_length, min_value, max_quotient, rank_idx, args, &bucket, &bucket_start, &bucket_end, &instruction_counter);
+
+    // QR Sort the prefix holding every bucket up to and including the located one; it holds only bucket + 1 quotients
+    qr_sort_passes(arr, aux_arr, keys, counting_arr, counter_size, bucket_end, min_value, bucket + 1, args, &instruction_counter);
+
+    free(aux_arr);
+    free(counting_arr);
+    free(keys);
+    return instruction_counter;
+}
@@ -3,6 +3,7 @@
  * @date: 01/12/2024
  */
 #include "../sort.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include "math.h"
 
@@ -16,22 +17,22 @@
  * @param args additional sorting arguments
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void compute_remainder_keys(const int arr[], int keys[], const int arr_length, const int min_value, const int max_quotient, const SortArgs args, unsigned long long int *instruction_counter) {
+void compute_remainder_keys(const int arr[], int keys[], const size_t arr_length, const int min_value, const int max_quotient, const SortArgs args, unsigned long long int *instruction_counter) {
     if (args.bitwise_ops) {  // Use bitwise operations to compute the remainders
-        *instruction_counter += (4 * arr_length) + 1;
+        *instruction_counter += (SHIFT_KEY_INSTRUCTION_WEIGHT * arr_length) + 1;
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = arr[i] & (args.divisor - 1);
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] - min_value) & (args.divisor - 1);
     } else {
-        *instruction_counter += (3 * arr_length) + 1 + (DIVISION_INSTRUCTION_WEIGHT * arr_length);  // Add weighted modulo operation count
+        *instruction_counter += (KEY_INSTRUCTION_WEIGHT * arr_length) + 1 + (DIVISION_INSTRUCTION_WEIGHT * arr_length);  // Add weighted modulo operation count
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = arr[i] % args.divisor;
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] - min_value) % args.divisor;
     }
 }
@@ -45,72 +46,120 @@ void compute_remainder_keys(const int arr[], int keys[], const int arr_length, c
  * @param args additional sorting arguments
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void compute_quotient_keys(const int arr[], int keys[], const int arr_length, const int min_value, const SortArgs args, unsigned long long int *instruction_counter) {
+void compute_quotient_keys(const int arr[], int keys[], const size_t arr_length, const int min_value, const SortArgs args, unsigned long long int *instruction_counter) {
     if (args.bitwise_ops) {
-        *instruction_counter += (4 * arr_length) + 1;
+        *instruction_counter += (SHIFT_KEY_INSTRUCTION_WEIGHT * arr_length) + 1;
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = arr[i] >> __builtin_ctz(args.divisor); // Bitwise shift for power of 2 divisor
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] - min_value) >> __builtin_ctz(args.divisor); // Bitwise shift for power of 2 divisor
     } else {
-        *instruction_counter += (3 * arr_length) + 1 + (DIVISION_INSTRUCTION_WEIGHT * arr_length); // Add weighted division operation count
+        *instruction_counter += (KEY_INSTRUCTION_WEIGHT * arr_length) + 1 + (DIVISION_INSTRUCTION_WEIGHT * arr_length); // Add weighted division operation count
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = arr[i] / args.divisor;
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] - min_value) / args.divisor;
     }
 }
 
 /**
- * Performs QR Sort on the given array.
+ * Prepares the state shared by QR Sort, QR Select, and QR Partial Sort. Finds the minimum value, assigns the default
+ * divisor if none was given, computes the number of quotient buckets, and allocates the auxiliary, counting, and keys
+ * arrays. The caller frees the three arrays. Counters are COUNTER_SIZE(arr_length) bytes wide.
  * @param arr the array to be sorted
  * @param arr_length the length of the array
- * @param args additional sorting arguments
- * @return the total number of instructions executed during the sort
+ * @param args additional sorting arguments; args->divisor is assigned if not a positive int
+ * @param min_value pointer to store the minimum value in arr
+ * @param max_quotient pointer to store the number of quotient buckets
+ * @param aux_arr pointer to store the auxiliary array of arr_length elements
+ * @param counting_arr pointer to store the zeroed counting array of max(divisor, max_quotient) elements
+ * @param keys pointer to store the keys array of arr_length elements
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ * @return 0 on success, and 1 if the arrays could not be allocated, in which case none remain allocated
  */
-unsigned long long int qr_sort(int arr[], const int arr_length, SortArgs args) {
-    unsigned long long int instruction_counter = 0;
-
+int qr_sort_setup(const int arr[], const size_t arr_length, SortArgs *args, int *min_value, int *max_quotient, int **aux_arr, void **counting_arr, int **keys, unsigned long long int *instruction_counter) {
     // Find min and max array values to get the max_quotient value
-    int min_value = 0, max_value = 0;
-    if (args.min_value_zero)
-        find_max(arr, arr_length, &max_value, &instruction_counter);
+    int max_value = 0;
+    *min_value = 0;
+    if (args->min_value_zero)
+        find_max(arr, arr_length, &max_value, instruction_counter);
     else
-        find_min_max(arr, arr_length, &min_value, &max_value, &instruction_counter);
+        find_min_max(arr, arr_length, min_value, &max_value, instruction_counter);
 
-    // If divisor is not a positive int, assign to arr_length
-    if (args.divisor <= 0)
-        args.divisor = ceil(sqrt(max_value - min_value + 1)); // (arr_length < max_value - min_value + 1) ? arr_length : max_value - min_value + 1;
-    int divisor = args.divisor;
+    // If divisor is not a positive int, assign to sqrt of the value range
+    if (args->divisor <= 0)
+        args->divisor = ceil(sqrt(max_value - *min_value + 1)); // (arr_length < max_value - min_value + 1) ? arr_length : max_value - min_value + 1;
+    int divisor = args->divisor;
 
-    int max_quotient = ((max_value - min_value) / divisor) + 1;
-    instruction_counter += DIVISION_INSTRUCTION_WEIGHT;
+    *max_quotient = ((max_value - *min_value) / divisor) + 1;
+    *instruction_counter += DIVISION_INSTRUCTION_WEIGHT;
 
     // Define auxiliary array and counting array
-    int* aux_arr = malloc(arr_length * sizeof(int));
-    int* counting_arr = calloc(divisor > max_quotient ? divisor : max_quotient, sizeof(int));
-    int* keys = malloc(arr_length * sizeof(int));
-    compute_remainder_keys(arr, keys, arr_length, min_value, max_quotient, args, &instruction_counter);
+    *aux_arr = huge_malloc(arr_length * sizeof(int));
+    *counting_arr = huge_calloc(divisor > *max_quotient ? divisor : *max_quotient, COUNTER_SIZE(arr_length));
+    *keys = huge_malloc(arr_length * sizeof(int));
+    if (*aux_arr == NULL || *counting_arr == NULL || *keys == NULL) {
+        perror("QR Sort could not allocate its buffers");
+        free(*aux_arr);
+        free(*counting_arr);
+        free(*keys);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Sorts arr by remainder and then by quotient with two counting passes, leaving the result in arr.
+ * @param arr the array to be sorted
+ * @param aux_arr an auxiliary array of at least arr_length elements
+ * @param keys a keys array of at least arr_length elements
+ * @param counting_arr a zeroed counting array of at least max(divisor, max_quotient) elements
+ * @param counter_size the size of each counter in counting_arr in bytes, as given by COUNTER_SIZE
+ * @param arr_length the length of arr
+ * @param min_value the minimum value in arr
+ * @param max_quotient the number of quotient buckets
+ * @param args additional sorting arguments; args.divisor must be a positive int
+ * @param instruction_counter pointer to the counter tracking the number of instructions
+ */
+void qr_sort_passes(int arr[], int aux_arr[], int keys[], void *counting_arr, const size_t counter_size, const size_t arr_length, const int min_value, const int max_quotient, const SortArgs args, unsigned long long int *instruction_counter) {
+    int divisor = args.divisor;
+    compute_remainder_keys(arr, keys, arr_length, min_value, max_quotient, args, instruction_counter);
 
     if (max_quotient == 1)
-        counting_key_sort(arr, aux_arr, keys, counting_arr, arr_length, divisor, 1, &instruction_counter);
+        counting_key_sort(arr, aux_arr, keys, counting_arr, counter_size, arr_length, divisor, 1, instruction_counter);
     else {
-        counting_key_sort(arr, aux_arr, keys, counting_arr, arr_length, divisor, 0,
-                          &instruction_counter);  // Perform Counting Sort on the Remainder Keys
+        counting_key_sort(arr, aux_arr, keys, counting_arr, counter_size, arr_length, divisor, 0,
+                          instruction_counter);  // Perform Counting Sort on the Remainder Keys
 
-        instruction_counter += 2 * (divisor > max_quotient ? max_quotient : divisor) + 1;
-        for (int i = 0; i < (divisor > max_quotient ? max_quotient : divisor); ++i)  // Reset Counting Array
-            counting_arr[i] = 0;
+        *instruction_counter += RESET_INSTRUCTION_WEIGHT * (divisor > max_quotient ? max_quotient : divisor) + 1;
+        reset_counters(counting_arr, counter_size, divisor > max_quotient ? max_quotient : divisor);  // Reset Counting Array
 
         // Compute, then sort quotient keys
-        compute_quotient_keys(aux_arr, keys, arr_length, min_value, args, &instruction_counter);
-        counting_key_sort(aux_arr, arr, keys, counting_arr, arr_length, max_quotient, 0, &instruction_counter);
+        compute_quotient_keys(aux_arr, keys, arr_length, min_value, args, instruction_counter);
+        counting_key_sort(aux_arr, arr, keys, counting_arr, counter_size, arr_length, max_quotient, 0, instruction_counter);
     }
+}
+
+/**
+ * Performs QR Sort on the given array.
+ * @param arr the array to be sorted
+ * @param arr_length the length of the array
+ * @param args additional sorting arguments
+ * @return the total number of instructions executed during the sort
+ */
+unsigned long long int qr_sort(int arr[], const size_t arr_length, SortArgs args) {
+    unsigned long long int instruction_counter = 0;
 
+    int min_value, max_quotient;
+    int *aux_arr, *keys;
+    void *counting_arr;
+    if (qr_sort_setup(arr, arr_length, &args, &min_value, &max_quotient, &aux_arr, &counting_arr, &keys, &instruction_counter))
+        return SORT_ALLOCATION_FAILED;
+    qr_sort_passes(arr, aux_arr, keys, counting_arr, COUNTER_SIZE(arr_length), arr_length, min_value, max_quotient, args, &instruction_counter);
 
     free(aux_arr);
     free(counting_arr);
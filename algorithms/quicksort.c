@@ -13,12 +13,12 @@
  * @param instruction_counter pointer to the counter tracking the number of instructions
  * @return the new index of the pivot element after partitioning
  */
-int partition(int arr[], const int start_idx, const int end_idx, unsigned long long int* instruction_counter) {
+ptrdiff_t partition(int arr[], const ptrdiff_t start_idx, const ptrdiff_t end_idx, unsigned long long int* instruction_counter) {
     ++(*instruction_counter);
     int x = arr[end_idx];
-    int i = start_idx - 1;
+    ptrdiff_t i = start_idx - 1;
 
-    for (int j = start_idx; ++(*instruction_counter) && j < end_idx; ++j)
+    for (ptrdiff_t j = start_idx; ++(*instruction_counter) && j < end_idx; ++j)
         if ((*instruction_counter += 2) && arr[j] < x)
             swap(arr, ++i, j, instruction_counter);
 
@@ -34,10 +34,10 @@ int partition(int arr[], const int start_idx, const int end_idx, unsigned long l
  * @param end_idx the end index of the sub-array to be sorted
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void recursive_quicksort(int arr[], const int start_idx, const int end_idx, unsigned long long int* instruction_counter) {
+void recursive_quicksort(int arr[], const ptrdiff_t start_idx, const ptrdiff_t end_idx, unsigned long long int* instruction_counter) {
     if (++(*instruction_counter) && end_idx - start_idx < 1)
         return;
-    int p = partition(arr, start_idx, end_idx, instruction_counter);
+    ptrdiff_t p = partition(arr, start_idx, end_idx, instruction_counter);
     recursive_quicksort(arr, start_idx, p - 1, instruction_counter);
     recursive_quicksort(arr, p + 1, end_idx, instruction_counter);
 }
@@ -49,8 +49,34 @@ void recursive_quicksort(int arr[], const int start_idx, const int end_idx, unsi
  * @param args additional sorting arguments (not used in this implementation)
  * @return the total number of instructions executed during the sort
  */
-unsigned long long int quicksort(int arr[], const int arr_length, const SortArgs args) {
+unsigned long long int quicksort(int arr[], const size_t arr_length, const SortArgs args) {
     unsigned long long int instruction_counter = 0;  // # of comparisons + array accesses
-    recursive_quicksort(arr, 0, arr_length - 1, &instruction_counter);
+    recursive_quicksort(arr, 0, (ptrdiff_t) arr_length - 1, &instruction_counter);
+    return instruction_counter;
+}
+
+/**
+ * Performs Quickselect on the given array, placing the k-th smallest element at index k - 1 with all smaller elements
+ * before it and all larger elements after it.
+ * @param arr the array to be partitioned
+ * @param arr_length the length of the array
+ * @param args additional sorting arguments; args.rank specifies k
+ * @return the total number of instructions executed during the selection
+ */
+unsigned long long int quickselect(int arr[], const size_t arr_length, const SortArgs args) {
+    unsigned long long int instruction_counter = 0;  // # of comparisons + array accesses
+    ptrdiff_t rank_idx = (ptrdiff_t) ((args.rank > 0 && args.rank <= arr_length) ? args.rank : (arr_length + 1) / 2) - 1;
+    ptrdiff_t start_idx = 0, end_idx = (ptrdiff_t) arr_length - 1;
+
+    while (++instruction_counter && start_idx < end_idx) {
+        ptrdiff_t p = partition(arr, start_idx, end_idx, &instruction_counter);
+        instruction_counter += 2;
+        if (p == rank_idx)
+            break;
+        else if (p < rank_idx)
+            start_idx = p + 1;
+        else
+            end_idx = p - 1;
+    }
     return instruction_counter;
 }
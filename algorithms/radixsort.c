@@ -4,6 +4,8 @@
  */
 #include "../sort_utils.h"
 #include "../sort.h"
+#include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 /**
@@ -16,22 +18,22 @@
  * @param args additional sorting arguments
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void compute_keys(const int arr[], int keys[], const int arr_length, const int min_value, const unsigned long long int exp, const SortArgs args, unsigned long long int *instruction_counter) {
+void compute_keys(const int arr[], int keys[], const size_t arr_length, const int min_value, const unsigned long long int exp, const SortArgs args, unsigned long long int *instruction_counter) {
     if (args.bitwise_ops) {
-        *instruction_counter += 5 * arr_length + 1;
+        *instruction_counter += (SHIFT_KEY_INSTRUCTION_WEIGHT + 1) * arr_length + 1;  // Shift key plus the radix mask
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] >> __builtin_ctz(exp)) & (args.radix - 1);
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = ((arr[i] - min_value) >> __builtin_ctz(exp)) & (args.radix - 1);
     } else {
-        *instruction_counter += (3 * arr_length) + 1 + (2 * DIVISION_INSTRUCTION_WEIGHT * arr_length);  // Add weighted division and modulo operation count
+        *instruction_counter += (KEY_INSTRUCTION_WEIGHT * arr_length) + 1 + (2 * DIVISION_INSTRUCTION_WEIGHT * arr_length);  // Add weighted division and modulo operation count
         if (args.min_value_zero)
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = (arr[i] / exp) % args.radix;
         else
-            for (int i = 0; i < arr_length; ++i)
+            for (size_t i = 0; i < arr_length; ++i)
                 keys[i] = ((arr[i] - min_value) / exp) % args.radix;
     }
 }
@@ -43,11 +45,11 @@ void compute_keys(const int arr[], int keys[], const int arr_length, const int m
  * @param args additional sorting arguments
  * @return the total number of instructions executed during the sort.
  */
-unsigned long long int radix_sort(int arr[], const int arr_length, SortArgs args) {
+unsigned long long int radix_sort(int arr[], const size_t arr_length, SortArgs args) {
     unsigned long long int instruction_counter = 0;  // # of comparisons + array accesses
 
     // Determine the radix (base) for the sorting; defaults to arr_length if not specified
-    int radix = (args.radix > 0) ? args.radix : arr_length;
+    int radix = (args.radix > 0) ? args.radix : (arr_length < INT_MAX) ? (int) arr_length : INT_MAX;
     args.radix = radix;
 
     // Find the minimum and maximum values in the array for range calculation
@@ -60,9 +62,17 @@ unsigned long long int radix_sort(int arr[], const int arr_length, SortArgs args
     max_value -= min_value;  // Normalize max value based on min value
 
     // Allocate memory for auxiliary array and keys
-    int* aux_arr = malloc(arr_length * sizeof(int));
-    int* keys = malloc(arr_length * sizeof(int));
-    int* counting_arr = calloc(radix, sizeof(int));
+    int* aux_arr = huge_malloc(arr_length * sizeof(int));
+    int* keys = huge_malloc(arr_length * sizeof(int));
+    size_t counter_size = COUNTER_SIZE(arr_length);
+    void* counting_arr = huge_calloc(radix, counter_size);
+    if (aux_arr == NULL || keys == NULL || counting_arr == NULL) {
+        perror("Radix Sort could not allocate its buffers");
+        free(aux_arr);
+        free(counting_arr);
+        free(keys);
+        return SORT_ALLOCATION_FAILED;
+    }
 
     // Initialize pointers for swapping arrays
     int* temp_a = arr;
@@ -81,14 +91,13 @@ unsigned long long int radix_sort(int arr[], const int arr_length, SortArgs args
 
         // Perform counting sort on the keys
         if (!is_next_radix)
-            counting_key_sort(temp_a, temp_b, keys, counting_arr, arr_length, radix, arr == temp_a, &instruction_counter);
+            counting_key_sort(temp_a, temp_b, keys, counting_arr, counter_size, arr_length, radix, arr == temp_a, &instruction_counter);
         else {
-            counting_key_sort(temp_a, temp_b, keys, counting_arr, arr_length, radix, 0, &instruction_counter);
+            counting_key_sort(temp_a, temp_b, keys, counting_arr, counter_size, arr_length, radix, 0, &instruction_counter);
 
             // Reset Counting Array Values
-            instruction_counter += 2 * arr_length + 1;
-            for (int i = 0; i < radix; ++i)
-                counting_arr[i] = 0;
+            instruction_counter += RESET_INSTRUCTION_WEIGHT * arr_length + 1;
+            reset_counters(counting_arr, counter_size, radix);
 
             // Swap pointers to avoid extra copy from aux_arr to arr
             temp = temp_a;
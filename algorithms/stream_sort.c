@@ -0,0 +1,116 @@
+/**
+ * @author: Randolph Bushman
+ * @date: 10/19/2026
+ */
+#include "../sort_utils.h"
+#include "../sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Initializes a stream sorter with no elements.
+ * @param sorter the stream sorter to initialize
+ * @param capacity the number of elements to allocate space for up front; grown as needed
+ * @param batch_sort_func the sorting algorithm used to sort each appended batch
+ * @param batch_args the arguments passed to batch_sort_func
+ * @return 0 on success, and 1 if the buffers could not be allocated, in which case the sorter holds no buffers
+ */
+int stream_sorter_init(StreamSorter *sorter, const size_t capacity, const SortFunc batch_sort_func, const SortArgs batch_args) {
+    sorter->capacity = (capacity > 0) ? capacity : 1;
+    sorter->length = 0;
+    sorter->arr = malloc(sorter->capacity * sizeof(int));
+    sorter->aux_arr = huge_malloc(sorter->capacity * sizeof(int));
+    sorter->batch_sort_func = batch_sort_func;
+    sorter->batch_args = batch_args;
+    if (sorter->arr == NULL || sorter->aux_arr == NULL) {
+        perror("Stream Sorter could not allocate its buffers");
+        stream_sorter_free(sorter);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Appends a batch of elements to the stream sorter. The batch is sorted on its own and then merged into the sorted
+ * elements. Only the sorted elements greater than the batch's minimum value take part in the merge, so batches whose
+ * values fall at or above everything seen so far are appended without merging.
+ * @param sorter the stream sorter to append to
+ * @param batch the elements to append
+ * @param batch_length the length of batch
+ * @return the total number of instructions executed during the append, or SORT_ALLOCATION_FAILED if the buffers could
+ *         not be grown or the batch could not be sorted, in which case the sorted elements are unchanged
+ */
+unsigned long long int stream_sorter_append(StreamSorter *sorter, const int batch[], const size_t batch_length) {
+    unsigned long long int instruction_counter = 0;
+    if (batch_length < 1)
+        return instruction_counter;
+
+    // Grow the buffers geometrically so appends are amortized O(batch_length) in copying
+    if (sorter->length + batch_length > sorter->capacity) {
+        size_t capacity = sorter->capacity;
+        while (sorter->length + batch_length > capacity)
+            capacity *= 2;
+
+        // aux_arr is only scratch space, so it is replaced rather than reallocated to avoid copying stale elements
+        int *aux_arr = huge_malloc(capacity * sizeof(int));
+        int *arr = (aux_arr != NULL) ? realloc(sorter->arr, capacity * sizeof(int)) : NULL;
+        if (arr == NULL) {
+            perror("Stream Sorter could not grow its buffers");
+            free(aux_arr);
+            return SORT_ALLOCATION_FAILED;
+        }
+        free(sorter->aux_arr);
+        sorter->arr = arr;
+        sorter->aux_arr = aux_arr;
+        sorter->capacity = capacity;
+    }
+
+    // Sort the batch in place at the end of the sorted elements
+    int *tail = sorter->arr + sorter->length;
+    clone_array(batch, tail, batch_length);
+    instruction_counter += COPY_INSTRUCTION_WEIGHT * batch_length + 1;
+    unsigned long long int batch_instructions = (*sorter->batch_sort_func)(tail, batch_length, sorter->batch_args);
+    if (batch_instructions == SORT_ALLOCATION_FAILED)
+        return SORT_ALLOCATION_FAILED;
+    instruction_counter += batch_instructions;
+
+    // Binary search for the first sorted element greater than the batch minimum; everything before it stays in place
+    size_t low = 0, high = sorter->length;
+    while (++instruction_counter && low < high) {
+        size_t mid = (low + high) >> 1;
+        instruction_counter += 3;
+        if (sorter->arr[mid] <= tail[0])
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low < sorter->length)
+        merge(sorter->arr, sorter->aux_arr, low, sorter->length - 1, sorter->length + batch_length - 1, &instruction_counter);
+    sorter->length += batch_length;
+    return instruction_counter;
+}
+
+/**
+ * Returns the sorted view of every element appended so far. The view is valid until the next append.
+ * @param sorter the stream sorter to view
+ * @param length pointer to store the number of elements in the view
+ * @return the sorted elements
+ */
+const int* stream_sorter_view(const StreamSorter *sorter, size_t *length) {
+    *length = sorter->length;
+    return sorter->arr;
+}
+
+/**
+ * Frees the memory held by a stream sorter.
+ * @param sorter the stream sorter to free
+ */
+void stream_sorter_free(StreamSorter *sorter) {
+    free(sorter->arr);
+    free(sorter->aux_arr);
+    sorter->arr = NULL;
+    sorter->aux_arr = NULL;
+    sorter->length = 0;
+    sorter->capacity = 0;
+}
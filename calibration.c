@@ -0,0 +1,410 @@
+/**
+ * @author: Randolph Bushman
+ * @date: 10/19/2026
+ *
+ * Calibrates the instruction model against the host machine. Each primitive operation the counting kernels are built
+ * from is timed on its own, its per-element cost is converted into an instruction weight, and the calibrated weights are
+ * checked by how well they predict each sorting algorithm's measured runtime.
+ */
+#include "calibration.h"
+#include "sort_utils.h"
+#include "sort.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define CALIBRATION_ALGORITHM_COUNT 5  // Number of sorting algorithms whose runtime is checked against the model
+
+char *primitive_names[PRIMITIVE_COUNT] = {"copy", "key", "division", "modulo", "shift", "histogram", "prefix sum", "scatter", "reset"};
+char *calibration_algorithm_names[CALIBRATION_ALGORITHM_COUNT] = {"Merge Sort", "Quicksort", "Counting Sort", "Radix Sort", "QR Sort"};
+SortFunc calibration_algorithms[CALIBRATION_ALGORITHM_COUNT] = {merge_sort, quicksort, counting_sort, radix_sort, qr_sort};
+
+/**
+ * Fits y = slope * x + intercept by ordinary least squares.
+ * @param x the independent values
+ * @param y the dependent values
+ * @param count the number of (x, y) pairs
+ * @param slope pointer to store the fitted slope
+ * @param intercept pointer to store the fitted intercept
+ * @param r_squared pointer to store the coefficient of determination of the fit
+ */
+void linear_fit(const double x[], const double y[], const int count, double *slope, double *intercept, double *r_squared) {
+    double mean_x = 0, mean_y = 0;
+    for (int i = 0; i < count; ++i) {
+        mean_x += x[i] / count;
+        mean_y += y[i] / count;
+    }
+
+    double cov_xy = 0, var_x = 0, var_y = 0;
+    for (int i = 0; i < count; ++i) {
+        cov_xy += (x[i] - mean_x) * (y[i] - mean_y);
+        var_x += (x[i] - mean_x) * (x[i] - mean_x);
+        var_y += (y[i] - mean_y) * (y[i] - mean_y);
+    }
+
+    *slope = (var_x > 0) ? cov_xy / var_x : 0;
+    *intercept = mean_y - *slope * mean_x;
+    *r_squared = (var_x > 0 && var_y > 0) ? (cov_xy * cov_xy) / (var_x * var_y) : 0;
+}
+
+/**
+ * Times one pass of a primitive operation over every element of arr. Each primitive mirrors the inner loop of a
+ * counting kernel, and the counting arrays are prepared before the clock starts so that only the primitive is timed.
+ * @param primitive the index of the primitive in primitive_names
+ * @param arr the input values; all in [min_value, divisor * divisor)
+ * @param keys the output array; also holds the remainder keys of arr for the histogram and scatter primitives
+ * @param aux_arr the scatter destination
+ * @param counting_arr a counting array of divisor elements
+ * @param bucket_ends the exclusive end index of each remainder bucket, copied into counting_arr before a scatter
+ * @param counters an array of arr_length counters for the prefix sum and reset primitives
+ * @param arr_length the length of arr, keys, aux_arr, and counters
+ * @param min_value the minimum value in arr, subtracted by the key primitives as the kernels do
+ * @param divisor the divisor used by the division, modulo, and shift primitives
+ * @return the nanoseconds taken by the pass
+ */
+double time_primitive(const int primitive, const int arr[], int keys[], int aux_arr[], uint32_t counting_arr[], const size_t bucket_ends[], uint32_t counters[], const size_t arr_length, const int min_value, const int divisor) {
+    int shift = __builtin_ctz(divisor);
+    if (primitive == 5)
+        for (size_t i = 0; i < (size_t) divisor; ++i)
+            counting_arr[i] = 0;
+    else if (primitive == 7)
+        for (size_t i = 0; i < (size_t) divisor; ++i)
+            counting_arr[i] = (uint32_t) bucket_ends[i];
+    else if (primitive == 6)
+        for (size_t i = 0; i < arr_length; ++i)
+            counters[i] = 1;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    switch (primitive) {
+        case 0:
+            for (size_t i = 0; i < arr_length; ++i)
+                keys[i] = arr[i];
+            break;
+        case 1:
+            for (size_t i = 0; i < arr_length; ++i)
+                keys[i] = arr[i] - min_value;
+            break;
+        case 2:
+            for (size_t i = 0; i < arr_length; ++i)
+                keys[i] = (arr[i] - min_value) / divisor;
+            break;
+        case 3:
+            for (size_t i = 0; i < arr_length; ++i)
+                keys[i] = (arr[i] - min_value) % divisor;
+            break;
+        case 4:
+            for (size_t i = 0; i < arr_length; ++i)
+                keys[i] = (arr[i] - min_value) >> shift;
+            break;
+        case 5:
+            for (size_t i = 0; i < arr_length; ++i)
+                counting_arr[keys[i]]++;
+            break;
+        case 6:
+            for (size_t i = 1; i < arr_length; ++i)
+                counters[i] += counters[i - 1];
+            break;
+        case 7:
+            for (size_t i = arr_length; i-- > 0;)
+                aux_arr[--counting_arr[keys[i]]] = arr[i];
+            break;
+        default:
+            reset_counters(counters, sizeof(uint32_t), arr_length);
+            break;
+    }
+    return elapsed_ns(start);
+}
+
+/**
+ * Fits the per-element cost, in nanoseconds, of each primitive operation by regressing the best time of trial_cont
+ * passes against the array length.
+ * @param ns_per_element array of PRIMITIVE_COUNT elements to store the fitted per-element costs
+ * @param min_length the initial (smallest) array length
+ * @param max_length the maximum array length
+ * @param length_increment the increment for the next array length
+ * @param divisor the divisor used by the division, modulo, and shift primitives
+ * @param trial_cont the number of passes timed per array length
+ */
+void fit_primitive_costs(double ns_per_element[], const size_t min_length, const size_t max_length, const size_t length_increment, const int divisor, const int trial_cont) {
+    int point_count = (int) ((max_length - min_length) / length_increment) + 1;
+    double *lengths = malloc(point_count * sizeof(double));
+    double *times = malloc(point_count * sizeof(double));
+    int *arr = malloc(max_length * sizeof(int));
+    int *keys = malloc(max_length * sizeof(int));
+    int *aux_arr = malloc(max_length * sizeof(int));
+    uint32_t *counting_arr = calloc(divisor, sizeof(uint32_t));  // The kernels use 32-bit counters at these lengths
+    size_t *bucket_ends = calloc(divisor, sizeof(size_t));
+    uint32_t *counters = malloc(max_length * sizeof(uint32_t));
+
+    for (int p = 0; p < PRIMITIVE_COUNT; ++p) {
+        for (int j = 0; j < point_count; ++j) {
+            size_t arr_length = min_length + j * length_increment;
+            int min_value = divisor * divisor;
+            for (size_t i = 0; i < arr_length; ++i) {
+                arr[i] = generate_random_number(0, divisor * divisor - 1);
+                if (arr[i] < min_value)
+                    min_value = arr[i];
+            }
+
+            // Remainder keys and bucket end indices for the histogram and scatter primitives
+            for (size_t i = 0; i < (size_t) divisor; ++i)
+                bucket_ends[i] = 0;
+            for (size_t i = 0; i < arr_length; ++i) {
+                keys[i] = arr[i] % divisor;
+                bucket_ends[keys[i]]++;
+            }
+            for (size_t i = 1; i < (size_t) divisor; ++i)
+                bucket_ends[i] += bucket_ends[i - 1];
+
+            double best_time = -1;
+            for (int t = 0; t < trial_cont; ++t) {
+                double time = time_primitive(p, arr, keys, aux_arr, counting_arr, bucket_ends, counters, arr_length, min_value, divisor);
+                if (best_time < 0 || time < best_time)
+                    best_time = time;
+            }
+            lengths[j] = arr_length;
+            times[j] = best_time;
+        }
+
+        double intercept, r_squared;
+        linear_fit(lengths, times, point_count, &ns_per_element[p], &intercept, &r_squared);
+    }
+
+    free(lengths);
+    free(times);
+    free(arr);
+    free(keys);
+    free(aux_arr);
+    free(counting_arr);
+    free(bucket_ends);
+    free(counters);
+}
+
+/**
+ * Computes the modeled per-element cost of each primitive operation under the instruction weights currently loaded.
+ * @param modeled_costs array of PRIMITIVE_COUNT elements to store the modeled costs
+ */
+void model_primitive_costs(int modeled_costs[]) {
+    modeled_costs[0] = COPY_INSTRUCTION_WEIGHT;
+    modeled_costs[1] = KEY_INSTRUCTION_WEIGHT;
+    modeled_costs[2] = KEY_INSTRUCTION_WEIGHT + DIVISION_INSTRUCTION_WEIGHT;
+    modeled_costs[3] = KEY_INSTRUCTION_WEIGHT + DIVISION_INSTRUCTION_WEIGHT;
+    modeled_costs[4] = SHIFT_KEY_INSTRUCTION_WEIGHT;
+    modeled_costs[5] = HISTOGRAM_INSTRUCTION_WEIGHT;
+    modeled_costs[6] = PREFIX_SUM_INSTRUCTION_WEIGHT;
+    modeled_costs[7] = SCATTER_INSTRUCTION_WEIGHT;
+    modeled_costs[8] = RESET_INSTRUCTION_WEIGHT;
+}
+
+/**
+ * Converts the fitted per-element cost of each primitive into an instruction weight. One modeled instruction is priced
+ * at the primitives' total measured cost over their total modeled cost under the weights currently loaded, so the
+ * fitted weights stay on the scale of the weights they replace. The division weight is the mean cost of a division or
+ * modulo key less the cost of the same key without the division.
+ * @param ns_per_element the fitted per-element cost of each primitive
+ * @param fitted_weights array of INSTRUCTION_WEIGHT_COUNT elements to store the unrounded weights, in the order of
+ *                       instruction_weights
+ * @return the nanoseconds per modeled instruction
+ */
+double fit_instruction_weights(const double ns_per_element[], double fitted_weights[]) {
+    int modeled_costs[PRIMITIVE_COUNT];
+    model_primitive_costs(modeled_costs);
+    double measured_total = 0, modeled_total = 0;
+    for (int p = 0; p < PRIMITIVE_COUNT; ++p) {
+        measured_total += ns_per_element[p];
+        modeled_total += modeled_costs[p];
+    }
+    double ns_per_instruction = measured_total / modeled_total;
+
+    double instructions[PRIMITIVE_COUNT];
+    for (int p = 0; p < PRIMITIVE_COUNT; ++p)
+        instructions[p] = ns_per_element[p] / ns_per_instruction;
+    fitted_weights[0] = instructions[0];  // copy
+    fitted_weights[1] = instructions[1];  // key
+    fitted_weights[2] = (instructions[2] + instructions[3]) / 2 - instructions[1];  // division
+    fitted_weights[3] = instructions[4];  // shift key
+    fitted_weights[4] = instructions[5];  // histogram
+    fitted_weights[5] = instructions[6];  // prefix sum
+    fitted_weights[6] = instructions[7];  // scatter
+    fitted_weights[7] = instructions[8];  // reset
+    return ns_per_instruction;
+}
+
+/**
+ * Loads the given instruction weights, in the order of instruction_weights.
+ * @param weights the weights to load
+ */
+void set_instruction_weights(const int weights[]) {
+    for (int w = 0; w < INSTRUCTION_WEIGHT_COUNT; ++w)
+        *instruction_weights[w].weight = weights[w];
+}
+
+/**
+ * Times a sorting algorithm across the array length sweep, and records its instruction count under two sets of weights.
+ * The algorithm is timed once per trial; the count under the second set comes from an untimed run on the same input.
+ * @param func the sorting algorithm to time
+ * @param default_weights the weights the timed run is counted with
+ * @param calibrated_weights the weights the untimed run is counted with
+ * @param default_counts array to store the average instruction count under default_weights at each length
+ * @param calibrated_counts array to store the average instruction count under calibrated_weights at each length
+ * @param times array to store the average measured nanoseconds at each length
+ * @param min_length the initial (smallest) array length
+ * @param max_length the maximum array length
+ * @param length_increment the increment for the next array length
+ * @param min_value the minimum value in the arrays
+ * @param max_value the maximum value in the arrays
+ * @param trial_cont the number of trials per array length
+ */
+void measure_algorithm(const SortFunc func, const int default_weights[], const int calibrated_weights[], double default_counts[], double calibrated_counts[], double times[], const size_t min_length, const size_t max_length, const size_t length_increment, const int min_value, const int max_value, const int trial_cont) {
+    int *arr = malloc(max_length * sizeof(int));
+    int *copy_arr = malloc(max_length * sizeof(int));
+
+    int j = 0;
+    for (size_t arr_length = min_length; arr_length <= max_length; arr_length += length_increment, ++j) {
+        lin_space(arr, arr_length, min_value, max_value);
+        default_counts[j] = 0;
+        calibrated_counts[j] = 0;
+        times[j] = 0;
+        for (int t = 0; t < trial_cont; ++t) {
+            shuffle(arr, arr_length);
+
+            set_instruction_weights(default_weights);
+            clone_array(arr, copy_arr, arr_length);
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            default_counts[j] += (double) (*func)(copy_arr, arr_length, (SortArgs) {}) / trial_cont;
+            times[j] += elapsed_ns(start) / trial_cont;
+
+            set_instruction_weights(calibrated_weights);
+            clone_array(arr, copy_arr, arr_length);
+            calibrated_counts[j] += (double) (*func)(copy_arr, arr_length, (SortArgs) {}) / trial_cont;
+        }
+    }
+
+    set_instruction_weights(default_weights);
+    free(arr);
+    free(copy_arr);
+}
+
+/**
+ * Predicts each runtime as ns_per_instruction * count, with ns_per_instruction fitted once across every algorithm, and
+ * reports the mean absolute relative error of the prediction per algorithm and overall.
+ * @param counts the instruction counts, point_count per algorithm
+ * @param times the measured nanoseconds, point_count per algorithm
+ * @param point_count the number of array lengths measured per algorithm
+ * @param errors array of CALIBRATION_ALGORITHM_COUNT + 1 elements to store the mean relative error of each algorithm,
+ *               followed by the mean over every algorithm
+ * @return the shared nanoseconds per modeled instruction
+ */
+double evaluate_counts(const double counts[], const double times[], const int point_count, double errors[]) {
+    int total_points = CALIBRATION_ALGORITHM_COUNT * point_count;
+    double s_cc = 0, s_ct = 0;
+    for (int i = 0; i < total_points; ++i) {
+        s_cc += counts[i] * counts[i];
+        s_ct += counts[i] * times[i];
+    }
+    double ns_per_instruction = (s_cc > 0) ? s_ct / s_cc : 0;
+
+    errors[CALIBRATION_ALGORITHM_COUNT] = 0;
+    for (int a = 0; a < CALIBRATION_ALGORITHM_COUNT; ++a) {
+        errors[a] = 0;
+        for (int j = 0; j < point_count; ++j) {
+            int i = a * point_count + j;
+            errors[a] += fabs(ns_per_instruction * counts[i] - times[i]) / times[i] / point_count;
+        }
+        errors[CALIBRATION_ALGORITHM_COUNT] += errors[a] / CALIBRATION_ALGORITHM_COUNT;
+    }
+    return ns_per_instruction;
+}
+
+/**
+ * Fits every instruction weight from the measured per-element cost of the primitive operation it models, and reports
+ * how well the default and calibrated weights predict each sorting algorithm's runtime using one shared cost per modeled
+ * instruction. The calibrated weights are written to weights_file and left loaded. If any weight fits as non-positive,
+ * the model cannot describe this machine; an error is reported and no weights file is written.
+ * @param file the CSV file to write the per-algorithm prediction errors to
+ * @param weights_file the path of the weights file to write
+ * @param min_length the initial (smallest) array length
+ * @param max_length the maximum array length
+ * @param length_increment the increment for the next array length
+ * @param min_value the minimum value in the arrays
+ * @param max_value the maximum value in the arrays
+ * @param trial_cont the number of trials per array length
+ * @return 0 on success, and 1 if a weight fit as non-positive or the weights file could not be written
+ */
+int run_calibration(FILE *file, const char *weights_file, const size_t min_length, const size_t max_length, const size_t length_increment, const int min_value, const int max_value, const int trial_cont) {
+    int divisor = ceil(sqrt(max_value - min_value + 1));
+    int point_count = (int) ((max_length - min_length) / length_increment) + 1;
+    int total_points = CALIBRATION_ALGORITHM_COUNT * point_count;
+
+    int default_weights[INSTRUCTION_WEIGHT_COUNT], calibrated_weights[INSTRUCTION_WEIGHT_COUNT];
+    for (int w = 0; w < INSTRUCTION_WEIGHT_COUNT; ++w)
+        default_weights[w] = *instruction_weights[w].weight;
+    int default_costs[PRIMITIVE_COUNT], calibrated_costs[PRIMITIVE_COUNT];
+    model_primitive_costs(default_costs);
+
+    double ns_per_element[PRIMITIVE_COUNT], fitted_weights[INSTRUCTION_WEIGHT_COUNT];
+    fit_primitive_costs(ns_per_element, min_length, max_length, length_increment, divisor, trial_cont);
+    double ns_per_instruction = fit_instruction_weights(ns_per_element, fitted_weights);
+
+    printf("Weight, Default, Fitted\n");
+    int fit_failed = 0;
+    for (int w = 0; w < INSTRUCTION_WEIGHT_COUNT; ++w) {
+        printf("%s, %d, %.2f\n", instruction_weights[w].name, default_weights[w], fitted_weights[w]);
+        if (!(fitted_weights[w] > 0)) {
+            fprintf(stderr, "Calibration failed: %s fitted as %.2f; no weights file written\n", instruction_weights[w].name, fitted_weights[w]);
+            fit_failed = 1;
+        }
+        // Positive weights under half an instruction round up to the smallest integer weight
+        calibrated_weights[w] = (fitted_weights[w] < 1) ? 1 : (int) (fitted_weights[w] + 0.5);
+    }
+    if (fit_failed)
+        return 1;
+
+    set_instruction_weights(calibrated_weights);
+    model_primitive_costs(calibrated_costs);
+    set_instruction_weights(default_weights);
+    printf("Primitive, Measured ns per Element, Measured Instructions per Element, Modeled (Default), Modeled (Calibrated)\n");
+    for (int p = 0; p < PRIMITIVE_COUNT; ++p)
+        printf("%s, %.3f, %.2f, %d, %d\n", primitive_names[p], ns_per_element[p], ns_per_element[p] / ns_per_instruction, default_costs[p], calibrated_costs[p]);
+
+    // Every algorithm is timed once; both sets of weights are evaluated against the same timings
+    double *default_counts = malloc(total_points * sizeof(double));
+    double *calibrated_counts = malloc(total_points * sizeof(double));
+    double *times = malloc(total_points * sizeof(double));
+    for (int a = 0; a < CALIBRATION_ALGORITHM_COUNT; ++a)
+        measure_algorithm(calibration_algorithms[a], default_weights, calibrated_weights, default_counts + a * point_count, calibrated_counts + a * point_count, times + a * point_count, min_length, max_length, length_increment, min_value, max_value, trial_cont);
+
+    double default_errors[CALIBRATION_ALGORITHM_COUNT + 1], calibrated_errors[CALIBRATION_ALGORITHM_COUNT + 1];
+    evaluate_counts(default_counts, times, point_count, default_errors);
+    double calibrated_ns_per_instruction = evaluate_counts(calibrated_counts, times, point_count, calibrated_errors);
+
+    char *header = "Algorithm,Mean Relative Error (Default Weights),Mean Relative Error (Calibrated Weights)";
+    fprintf(file, "%s\n", header);
+    printf("%s\n", header);
+    for (int a = 0; a <= CALIBRATION_ALGORITHM_COUNT; ++a) {
+        char *name = (a < CALIBRATION_ALGORITHM_COUNT) ? calibration_algorithm_names[a] : "All Algorithms";
+        fprintf(file, "%s, %.4f, %.4f\n", name, default_errors[a], calibrated_errors[a]);
+        printf("%s, %.4f, %.4f\n", name, default_errors[a], calibrated_errors[a]);
+    }
+    printf("Nanoseconds per modeled instruction: %.4f\n", calibrated_ns_per_instruction);
+
+    free(default_counts);
+    free(calibrated_counts);
+    free(times);
+
+    set_instruction_weights(calibrated_weights);
+    FILE *weights = fopen(weights_file, "w");
+    if (weights == NULL) {
+        perror("Error opening weights file");
+        return 1;
+    }
+    fprintf(weights, "# Instruction weights calibrated on this machine; load with --weights_file\n");
+    fprintf(weights, "# Each weight is fitted from the measured per-element cost of its primitive (unrounded value in comments)\n");
+    for (int w = 0; w < INSTRUCTION_WEIGHT_COUNT; ++w)
+        fprintf(weights, "%s %d  # %.2f\n", instruction_weights[w].name, calibrated_weights[w], fitted_weights[w]);
+    fprintf(weights, "# Nanoseconds per modeled instruction: %.4f\n", calibrated_ns_per_instruction);
+    fclose(weights);
+    printf("Weights file: %s\n", weights_file);
+    return 0;
+}
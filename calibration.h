@@ -0,0 +1,16 @@
+/**
+ * @author: Randolph Bushman
+ * @date: 10/19/2026
+ */
+
+#include <stdio.h>
+
+#ifndef SORT_TESTER_CALIBRATION_H
+#define SORT_TESTER_CALIBRATION_H
+
+#define PRIMITIVE_COUNT 9  // Number of primitive operations timed during calibration
+
+void linear_fit(const double[], const double[], int, double*, double*, double*);
+int run_calibration(FILE*, const char*, size_t, size_t, size_t, int, int, int);
+
+#endif //SORT_TESTER_CALIBRATION_H
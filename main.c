@@ -11,12 +11,18 @@
 #include <stdlib.h>
 #include "sort_utils.h"
 #include "sort.h"
+#include "calibration.h"
 #include <string.h>
+#include <time.h>
 #define MAX_ALGORITHM_COUNT 24  // Maximum number of sorting algorithms that can be tested
 
 SortFunc sorting_algorithms[MAX_ALGORITHM_COUNT]; // Array of sorting algorithm functions
 SortArgs sorting_args[MAX_ALGORITHM_COUNT];       // Array of arguments for each sorting algorithm
 unsigned long long int algorithm_times[MAX_ALGORITHM_COUNT] = {0}; // Execution times for algorithms
+double algorithm_seconds[MAX_ALGORITHM_COUNT] = {0}; // Wall-clock seconds for algorithms
+const char* algorithm_names[MAX_ALGORITHM_COUNT]; // Names of the sorting algorithms
+int report_seconds = 0;                           // Flag indicating if wall-clock seconds are reported after the counts
+int verify_results = 0;                           // Flag indicating if each result is checked against a sorted reference
 char csv_column_str[1024] = "Array Length";       // CSV column header string
 int algorithm_count = 0;                          // Count of sorting algorithms added
 
@@ -31,26 +37,36 @@ int algorithm_count = 0;                          // Count of sorting algorithms
  * @param min_arr_value pointer to the minimum array value
  * @param max_arr_value pointer to the maximum array value
  * @param divisor pointer to the divisor for sorting algorithms
+ * @param length_multiplier pointer to the array length multiplier
+ * @param figure_mode pointer to the figure mode to generate
+ * @param batch_count pointer to the number of arrays sorted per batch in batch mode
+ * @param weights_file pointer to the instruction weights file name string
  * @param csv_file pointer to the CSV file name string
  */
-void parse_arguments(int argc, char *argv[], int *num_trials, int *initial_length, int *length_increment, int *max_length, int *min_arr_value, int *max_arr_value, int *divisor, int *figure_mode, char **csv_file) {
+void parse_arguments(int argc, char *argv[], int *num_trials, size_t *initial_length, size_t *length_increment, size_t *max_length, int *min_arr_value, int *max_arr_value, int *divisor, size_t *length_multiplier, int *figure_mode, int *batch_count, char **weights_file, char **csv_file) {
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "--num_trials")) {
             *num_trials = atoi(argv[++i]);
         } else if (!strcmp(argv[i], "--initial_length")) {
-            *initial_length = atoi(argv[++i]);
+            *initial_length = strtoull(argv[++i], NULL, 10);
         } else if (!strcmp(argv[i], "--length_increment")) {
-            *length_increment = atoi(argv[++i]);
+            *length_increment = strtoull(argv[++i], NULL, 10);
         } else if (!strcmp(argv[i], "--max_length")) {
-            *max_length = atoi(argv[++i]);
+            *max_length = strtoull(argv[++i], NULL, 10);
         } else if (!strcmp(argv[i], "--min_arr_value")) {
             *min_arr_value = atoi(argv[++i]);
         } else if (!strcmp(argv[i], "--max_arr_value")) {
             *max_arr_value = atoi(argv[++i]);
         } else if (!strcmp(argv[i], "--divisor")) {
-            *divisor = atoi(argv[++i]);}
-        else if (!strcmp(argv[i], "--figure_mode")) {
+            *divisor = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--length_multiplier")) {
+            *length_multiplier = strtoull(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--figure_mode")) {
             *figure_mode = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--batch_count")) {
+            *batch_count = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--weights_file")) {
+            *weights_file = argv[++i];
         } else if (!strcmp(argv[i], "--csv_file")) {
             *csv_file = argv[++i];
         }
@@ -65,26 +81,216 @@ void parse_arguments(int argc, char *argv[], int *num_trials, int *initial_lengt
  */
 void add_sorting_method(const char* name, const SortFunc func, const SortArgs args) {
     sprintf(csv_column_str, "%s,%s", csv_column_str, name);
+    algorithm_names[algorithm_count] = name;
     sorting_args[algorithm_count] = args;
     sorting_algorithms[algorithm_count++] = func;
 }
 
+/**
+ * Checks the output of a sorting, selection, or partial sorting algorithm against a sorted copy of its input. Selection
+ * algorithms must place the k-th smallest element at index k - 1, partial sorts must place the k smallest elements in
+ * order at the front, and every other algorithm must sort the whole array.
+ * @param func the algorithm that produced result
+ * @param args the arguments the algorithm was run with; args.rank specifies k for selection and partial sorts
+ * @param result the output of the algorithm
+ * @param reference the input of the algorithm in ascending order
+ * @param arr_length the length of result and reference
+ * @return 1 if the result is correct, and 0 otherwise
+ */
+int check_result(const SortFunc func, const SortArgs args, const int result[], const int reference[], const size_t arr_length) {
+    size_t rank = (args.rank > 0 && args.rank <= arr_length) ? args.rank : (arr_length + 1) / 2;
+    if (func == quickselect || func == qr_select)
+        return result[rank - 1] == reference[rank - 1];
+    if (func == qr_partial_sort) {
+        for (size_t i = 0; i < rank; ++i)
+            if (result[i] != reference[i])
+                return 0;
+        return 1;
+    }
+    return is_sorted_ascending(result, arr_length);
+}
+
+/**
+ * Measures the throughput, in arrays sorted per second, of sorting a batch of small arrays one qr_sort or quicksort call
+ * at a time versus a single batch_sort call, for each array length in the sweep.
+ * @param file the CSV file to write the results to
+ * @param min_length the initial (smallest) length of each array in the batch
+ * @param max_length the maximum length of each array in the batch
+ * @param length_increment the increment for the next array length
+ * @param min_value the minimum value in the arrays
+ * @param max_value the maximum value in the arrays
+ * @param trial_cont the number of trials per array length
+ * @param batch_count the number of arrays in each batch
+ * @return 0 on success, and 1 if the batch buffers could not be allocated
+ */
+int run_batch_benchmark(FILE *file, const size_t min_length, const size_t max_length, const size_t length_increment, const int min_value, const int max_value, const int trial_cont, const int batch_count) {
+    char *header = "Array Length,QR Sort (arrays/sec),Quicksort (arrays/sec),Batch Sort (arrays/sec)";
+    fprintf(file, "%s\n", header);
+    printf("%s\n", header);
+
+    int *arr = malloc((size_t) batch_count * max_length * sizeof(int));
+    int *copy_arr = malloc((size_t) batch_count * max_length * sizeof(int));
+    size_t *offsets = malloc((batch_count + 1) * sizeof(size_t));
+    if (arr == NULL || copy_arr == NULL || offsets == NULL) {
+        perror("Error allocating batch arrays");
+        free(arr);
+        free(copy_arr);
+        free(offsets);
+        return 1;
+    }
+
+    for (size_t arr_length = min_length; arr_length <= max_length; arr_length += length_increment) {
+        size_t total_length = batch_count * arr_length;
+        for (int i = 0; i <= batch_count; ++i)
+            offsets[i] = i * arr_length;
+        for (size_t i = 0; i < total_length; ++i)
+            arr[i] = generate_random_number(min_value, max_value);
+
+        double qr_sort_seconds = 0, quicksort_seconds = 0, batch_sort_seconds = 0;
+        for (int t = 0; t < trial_cont; ++t) {
+            clone_array(arr, copy_arr, total_length);
+            clock_t start = clock();
+            for (int i = 0; i < batch_count; ++i)
+                qr_sort(copy_arr + offsets[i], arr_length, (SortArgs) {});
+            qr_sort_seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+            clone_array(arr, copy_arr, total_length);
+            start = clock();
+            for (int i = 0; i < batch_count; ++i)
+                quicksort(copy_arr + offsets[i], arr_length, (SortArgs) {});
+            quicksort_seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+            clone_array(arr, copy_arr, total_length);
+            start = clock();
+            batch_sort(copy_arr, offsets, batch_count, (SortArgs) {});
+            batch_sort_seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+            for (int i = 0; i < batch_count; ++i)
+                if (!is_sorted_ascending(copy_arr + offsets[i], arr_length))
+                    fprintf(stderr, "Batch Sort failed to sort array %d of length %zu\n", i, arr_length);
+        }
+
+        double total_arrays = (double) batch_count * trial_cont;
+        fprintf(file, "%zu, %.0f, %.0f, %.0f\n", arr_length, total_arrays / qr_sort_seconds, total_arrays / quicksort_seconds, total_arrays / batch_sort_seconds);
+        printf("%zu, %.0f, %.0f, %.0f\n", arr_length, total_arrays / qr_sort_seconds, total_arrays / quicksort_seconds, total_arrays / batch_sort_seconds);
+    }
+
+    free(arr);
+    free(copy_arr);
+    free(offsets);
+    return 0;
+}
+
+/**
+ * Measures ingest throughput, in elements per second, of appending batches to a StreamSorter versus re-sorting the
+ * whole accumulated array with QR Sort after every batch.
+ * @param file the CSV file to write the results to
+ * @param batch_length the number of elements in each appended batch
+ * @param max_length the total number of elements to ingest
+ * @param min_value the minimum value in the batches
+ * @param max_value the maximum value in the batches
+ * @param trial_cont the number of times the whole stream is ingested
+ * @return 0 on success, and 1 if the stream buffers could not be allocated or an append failed
+ */
+int run_stream_benchmark(FILE *file, const size_t batch_length, const size_t max_length, const int min_value, const int max_value, const int trial_cont) {
+    char *header = "Array Length,Stream Sorter (elements/sec),QR Sort Re-sort (elements/sec)";
+    fprintf(file, "%s\n", header);
+    printf("%s\n", header);
+
+    size_t batch_count = max_length / batch_length;
+    int *stream = malloc(max_length * sizeof(int));
+    int *copy_arr = malloc(max_length * sizeof(int));
+    double *stream_seconds = calloc(batch_count, sizeof(double));
+    double *resort_seconds = calloc(batch_count, sizeof(double));
+    int status = 0;
+    if (stream == NULL || copy_arr == NULL || stream_seconds == NULL || resort_seconds == NULL) {
+        perror("Error allocating stream buffers");
+        status = 1;
+    }
+
+    for (int t = 0; t < trial_cont && !status; ++t) {
+        for (size_t i = 0; i < batch_count * batch_length; ++i)
+            stream[i] = generate_random_number(min_value, max_value);
+
+        StreamSorter sorter;
+        if (stream_sorter_init(&sorter, batch_length, qr_sort, (SortArgs) {})) {
+            status = 1;
+            break;
+        }
+        for (size_t b = 0; b < batch_count; ++b) {
+            size_t arr_length = (b + 1) * batch_length;
+
+            clock_t start = clock();
+            unsigned long long int instruction_count = stream_sorter_append(&sorter, stream + b * batch_length, batch_length);
+            stream_seconds[b] += (double) (clock() - start) / CLOCKS_PER_SEC;
+            if (instruction_count == SORT_ALLOCATION_FAILED) {
+                fprintf(stderr, "Stream Sorter failed to append at length %zu\n", arr_length);
+                status = 1;
+                break;
+            }
+
+            clone_array(stream, copy_arr, arr_length);
+            start = clock();
+            qr_sort(copy_arr, arr_length, (SortArgs) {});
+            resort_seconds[b] += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+            size_t view_length;
+            const int *view = stream_sorter_view(&sorter, &view_length);
+            if (!is_sorted_ascending(view, view_length))
+                fprintf(stderr, "Stream Sorter view is not sorted at length %zu\n", view_length);
+        }
+        stream_sorter_free(&sorter);
+    }
+
+    for (size_t b = 0; b < batch_count && !status; ++b) {
+        double total_elements = (double) batch_length * trial_cont;
+        fprintf(file, "%zu, %.0f, %.0f\n", (b + 1) * batch_length, total_elements / stream_seconds[b], total_elements / resort_seconds[b]);
+        printf("%zu, %.0f, %.0f\n", (b + 1) * batch_length, total_elements / stream_seconds[b], total_elements / resort_seconds[b]);
+    }
+
+    free(stream);
+    free(copy_arr);
+    free(stream_seconds);
+    free(resort_seconds);
+    return status;
+}
+
 int main(int argc, char *argv[]) {
     srand(0);
 
     // Trial parameters
-    int min_length = 100;          // Initial (smallest) array size to be tested
-    int max_length = 100000;           // Maximum array size to be tested
-    int length_increment = 1000;       // Increment for the next array size after each trial
+    size_t min_length = 0;          // Initial (smallest) array size to be tested; 0 selects the figure_mode's default
+    size_t max_length = 0;           // Maximum array size to be tested; 0 selects the figure_mode's default
+    size_t length_increment = 0;       // Increment for the next array size after each trial; 0 selects the figure_mode's default
+    size_t length_multiplier = 1;         // Multiplier for the next array size; when greater than 1 the sweep is geometric
     int min_value = 0;              // Minimum value in the arrays
     int max_value = 5000;       // Maximum value in the arrays
     int trial_cont = 100;                // Number of trials per array length
     int divisor = 16;                   // Common divisor for QR Sort optimizations (should be a power of 2)
     int figure_mode = 5;                // The number figure_mode to generate
+    int batch_count = 10000;            // Number of arrays sorted per batch in batch mode (figure_mode 8)
+    char *weights_file = NULL;          // Instruction weights file; loaded if given, written in calibration mode (figure_mode 11)
     char *csv_file = "output.csv";      // Output CSV file
 
     // Parse command line arguments
-    parse_arguments(argc, argv, &trial_cont, &min_length, &length_increment, &max_length, &min_value, &max_value, &divisor, &figure_mode, &csv_file);
+    parse_arguments(argc, argv, &trial_cont, &min_length, &length_increment, &max_length, &min_value, &max_value, &divisor, &length_multiplier, &figure_mode, &batch_count, &weights_file, &csv_file);
+
+    // Batch mode targets arrays of 10-1000 elements, so it gets its own length sweep
+    if (figure_mode == 8) {
+        min_length = (min_length > 0) ? min_length : 10;
+        max_length = (max_length > 0) ? max_length : 1000;
+        length_increment = (length_increment > 0) ? length_increment : 100;
+    } else {
+        min_length = (min_length > 0) ? min_length : 100;
+        max_length = (max_length > 0) ? max_length : 100000;
+        length_increment = (length_increment > 0) ? length_increment : 1000;
+    }
+
+    // Load instruction weights fitted by a previous calibration run
+    if (weights_file != NULL && figure_mode != 11 && !load_instruction_weights(weights_file)) {
+        perror("Error opening weights file");
+        return 1;
+    }
 
     // Open the CSV file for writing
     FILE *file = fopen(csv_file, "w");
@@ -94,6 +300,27 @@ int main(int argc, char *argv[]) {
     }
     printf("Output file: %s\n", csv_file);
 
+    // Batch mode measures throughput of many small arrays rather than instructions per array
+    if (figure_mode == 8) {
+        int status = run_batch_benchmark(file, min_length, max_length, length_increment, min_value, max_value, trial_cont, batch_count);
+        fclose(file);
+        return status;
+    }
+
+    // Calibration mode fits instruction weights to this machine and reports how well they predict runtime
+    if (figure_mode == 11) {
+        int status = run_calibration(file, (weights_file != NULL) ? weights_file : "weights.txt", min_length, max_length, length_increment, min_value, max_value, trial_cont);
+        fclose(file);
+        return status;
+    }
+
+    // Stream mode ingests batches of length_increment elements until max_length elements have arrived
+    if (figure_mode == 10) {
+        int status = run_stream_benchmark(file, length_increment, max_length, min_value, max_value, trial_cont);
+        fclose(file);
+        return status;
+    }
+
     // Add new sorting algorithms to be tested
     if (figure_mode == 5) {
         add_sorting_method("Merge Sort", merge_sort, (SortArgs) {});
@@ -110,6 +337,22 @@ int main(int argc, char *argv[]) {
         // add_sorting_method("QR Sort Min Value Zero", qr_sort, (SortArgs) {.divisor = divisor, .min_value_zero = 1});
         add_sorting_method("QR Sort: $d=2^{16}$ (Bitwise)", qr_sort, (SortArgs) {.divisor = divisor, .bitwise_ops = 1});
         // add_sorting_method("QR Sort Bitwise Min Value Zero", qr_sort, (SortArgs) {.divisor = divisor, .bitwise_ops = 1, .min_value_zero = 1});
+    } else if (figure_mode == 9) {
+        add_sorting_method("QR Sort: $d=\\sqrt{m}$", qr_sort, (SortArgs) {});
+        add_sorting_method("Quickselect: $k=n/2$", quickselect, (SortArgs) {});
+        add_sorting_method("QR Select: $k=n/2$", qr_select, (SortArgs) {});
+        add_sorting_method("QR Partial Sort: $k=100$", qr_partial_sort, (SortArgs) {.rank = 100});
+        verify_results = 1;
+    } else if (figure_mode == 12) {
+        // Huge-scale mode; run with e.g. --length_multiplier 10 --max_length 1000000000
+        add_sorting_method("Counting Sort", counting_sort, (SortArgs) {});
+        add_sorting_method("Radix Sort: $b=2^{16}$", radix_sort, (SortArgs) {.radix = 1 << 16});
+        add_sorting_method("QR Sort: $d=\\sqrt{m}$", qr_sort, (SortArgs) {});
+
+        // Modeled counts alone hide memory effects at this scale, so the measured wall-clock time is reported too
+        report_seconds = 1;
+        for (int i = 0; i < algorithm_count; ++i)
+            sprintf(csv_column_str + strlen(csv_column_str), ",%s (sec)", algorithm_names[i]);
     }
 
     // Print csv column headers
@@ -117,12 +360,19 @@ int main(int argc, char *argv[]) {
     printf("%s\n", csv_column_str);
 
     // Allocate memory for arrays
-    int *arr = malloc(max_length * sizeof(int));      // Array to sort
-    int *copy_arr = malloc(max_length * sizeof(int)); // Copy of the array for sorting
+    int *arr = huge_malloc(max_length * sizeof(int));      // Array to sort
+    int *copy_arr = huge_malloc(max_length * sizeof(int)); // Copy of the array for sorting
+    int *reference_arr = verify_results ? huge_malloc(max_length * sizeof(int)) : NULL; // Sorted copy of the array
+    if (arr == NULL || copy_arr == NULL || (verify_results && reference_arr == NULL)) {
+        perror("Error allocating arrays");
+        return 1;
+    }
 
     // Run sorting tests
-    for (int arr_length = min_length; arr_length <= max_length; arr_length += length_increment) {
+    for (size_t arr_length = min_length; arr_length <= max_length; arr_length = (length_multiplier > 1) ? arr_length * length_multiplier : arr_length + length_increment) {
         lin_space(arr, arr_length, min_value, max_value); // Populate arr with linearly spaced values
+        if (verify_results)
+            clone_array(arr, reference_arr, arr_length);  // arr is in ascending order until it is shuffled
 
         // Perform trials for each algorithm
         for (int i = 0; i < trial_cont; ++i) {
@@ -131,18 +381,39 @@ int main(int argc, char *argv[]) {
             // Test each algorithm
             for (int j = 0; j < algorithm_count; ++j) {
                 clone_array(arr, copy_arr, arr_length);  // Create a copy of the array for sorting
-                algorithm_times[j] += (*sorting_algorithms[j])(copy_arr, arr_length, sorting_args[j]);
+                struct timespec start;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                unsigned long long int instruction_count = (*sorting_algorithms[j])(copy_arr, arr_length, sorting_args[j]);
+                algorithm_seconds[j] += elapsed_ns(start) / 1e9;
+                if (instruction_count == SORT_ALLOCATION_FAILED) {
+                    fprintf(stderr, "%s failed to allocate its buffers at length %zu\n", algorithm_names[j], arr_length);
+                    fclose(file);
+                    free(arr);
+                    free(copy_arr);
+                    free(reference_arr);
+                    return 1;
+                }
+                algorithm_times[j] += instruction_count;
+                if (verify_results && !check_result(sorting_algorithms[j], sorting_args[j], copy_arr, reference_arr, arr_length))
+                    fprintf(stderr, "%s produced an incorrect result at length %zu\n", algorithm_names[j], arr_length);
             }
         }
 
         // Print the average time for each algorithm trial in CSV format
-        fprintf(file, "%d", arr_length);
-        printf("%d", arr_length);
+        fprintf(file, "%zu", arr_length);
+        printf("%zu", arr_length);
         for (int i = 0; i < algorithm_count; ++i) {
             fprintf(file, ", %llu", 1000 * algorithm_times[i] / trial_cont);
             printf( ", %llu", 1000 * algorithm_times[i] / trial_cont);
             algorithm_times[i] = 0;  // Reset time for the next trial
         }
+        for (int i = 0; i < algorithm_count; ++i) {
+            if (report_seconds) {
+                fprintf(file, ", %.6f", algorithm_seconds[i] / trial_cont);
+                printf(", %.6f", algorithm_seconds[i] / trial_cont);
+            }
+            algorithm_seconds[i] = 0;
+        }
         fprintf(file, "\n");
         printf("\n");
     }
@@ -150,5 +421,6 @@ int main(int argc, char *argv[]) {
     fclose(file);
     free(arr);
     free(copy_arr);
+    free(reference_arr);
     return 0;
 }
@@ -8,13 +8,36 @@
 #ifndef SORT_TESTER_SORT_H
 #define SORT_TESTER_SORT_H
 
+typedef struct {
+    int* arr;  // The sorted elements appended so far
+    int* aux_arr;  // Auxiliary array used when merging a batch into arr; scratch space only
+    size_t length;  // The number of elements in arr
+    size_t capacity;  // The number of elements arr and aux_arr can hold before growing
+    SortFunc batch_sort_func;  // The sorting algorithm used to sort each appended batch
+    SortArgs batch_args;  // The arguments passed to batch_sort_func
+} StreamSorter;
 
-unsigned long long int quicksort(int[], int, SortArgs);
-unsigned long long int merge_sort(int[], int, SortArgs);
-void counting_key_sort(int[], int[], const int[], int[], int, int, int, unsigned long long int*);
-unsigned long long int counting_sort(int[], int, SortArgs);
-unsigned long long int qr_sort(int[], int, SortArgs);
-unsigned long long int radix_sort(int[], int, SortArgs);
+ptrdiff_t partition(int[], ptrdiff_t, ptrdiff_t, unsigned long long int*);
+unsigned long long int quicksort(int[], size_t, SortArgs);
+unsigned long long int quickselect(int[], size_t, SortArgs);
+void merge(int[], int[], ptrdiff_t, ptrdiff_t, ptrdiff_t, unsigned long long int*);
+unsigned long long int merge_sort(int[], size_t, SortArgs);
+void counting_key_sort(int[], int[], const int[], void*, size_t, size_t, size_t, int, unsigned long long int*);
+unsigned long long int counting_sort(int[], size_t, SortArgs);
+int qr_sort_setup(const int[], size_t, SortArgs*, int*, int*, int**, void**, int**, unsigned long long int*);
+void qr_sort_passes(int[], int[], int[], void*, size_t, size_t, int, int, SortArgs, unsigned long long int*);
+unsigned long long int qr_sort(int[], size_t, SortArgs);
+unsigned long long int radix_sort(int[], size_t, SortArgs);
+void compute_remainder_keys(const int[], int[], size_t, int, int, SortArgs, unsigned long long int*);
+void compute_quotient_keys(const int[], int[], size_t, int, SortArgs, unsigned long long int*);
+void insertion_sort(int[], size_t, unsigned long long int*);
+unsigned long long int batch_sort(int[], const size_t[], size_t, SortArgs);
+unsigned long long int qr_select(int[], size_t, SortArgs);
+unsigned long long int qr_partial_sort(int[], size_t, SortArgs);
+int stream_sorter_init(StreamSorter*, size_t, SortFunc, SortArgs);
+unsigned long long int stream_sorter_append(StreamSorter*, const int[], size_t);
+const int* stream_sorter_view(const StreamSorter*, size_t*);
+void stream_sorter_free(StreamSorter*);
 
 
 #endif //SORT_TESTER_SORT_H
@@ -4,7 +4,31 @@
  */
 #include "sort_utils.h"
 #include <stdio.h>
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+int copy_instruction_weight = DEFAULT_COPY_INSTRUCTION_WEIGHT;
+int key_instruction_weight = DEFAULT_KEY_INSTRUCTION_WEIGHT;
+int division_instruction_weight = DEFAULT_DIVISION_INSTRUCTION_WEIGHT;
+int shift_key_instruction_weight = DEFAULT_SHIFT_KEY_INSTRUCTION_WEIGHT;
+int histogram_instruction_weight = DEFAULT_HISTOGRAM_INSTRUCTION_WEIGHT;
+int prefix_sum_instruction_weight = DEFAULT_PREFIX_SUM_INSTRUCTION_WEIGHT;
+int scatter_instruction_weight = DEFAULT_SCATTER_INSTRUCTION_WEIGHT;
+int reset_instruction_weight = DEFAULT_RESET_INSTRUCTION_WEIGHT;
+
+// Weights that can be loaded from a weights file, by name
+const InstructionWeight instruction_weights[INSTRUCTION_WEIGHT_COUNT] = {
+    {"copy_instruction_weight", &copy_instruction_weight},
+    {"key_instruction_weight", &key_instruction_weight},
+    {"division_instruction_weight", &division_instruction_weight},
+    {"shift_key_instruction_weight", &shift_key_instruction_weight},
+    {"histogram_instruction_weight", &histogram_instruction_weight},
+    {"prefix_sum_instruction_weight", &prefix_sum_instruction_weight},
+    {"scatter_instruction_weight", &scatter_instruction_weight},
+    {"reset_instruction_weight", &reset_instruction_weight},
+};
 
 /**
  * Given a reference array (arr) and an array to clone to (copy_arr), this function copies the values from
@@ -13,11 +37,22 @@
  * @param copy_arr the array to clone the reference values to
  * @param arr_length the length of arr; len(arr) == len(copy_arr)
  */
-void clone_array(const int arr[], int copy_arr[], const int arr_length) {
-    for(int i = 0; i < arr_length; ++i)
+void clone_array(const int arr[], int copy_arr[], const size_t arr_length) {
+    for(size_t i = 0; i < arr_length; ++i)
         copy_arr[i] = arr[i];
 }
 
+/**
+ * Returns the nanoseconds elapsed since the given start time.
+ * @param start the start time, taken from CLOCK_MONOTONIC
+ * @return the elapsed nanoseconds
+ */
+double elapsed_ns(const struct timespec start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
 /**
  * Finds the maximum value in the given array.
  * @param arr the array to search
@@ -25,8 +60,8 @@ void clone_array(const int arr[], int copy_arr[], const int arr_length) {
  * @param max a pointer to store the max value
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void find_max(const int arr[], const int arr_length, int *max, unsigned long long int *instruction_counter) {
-    int i;
+void find_max(const int arr[], const size_t arr_length, int *max, unsigned long long int *instruction_counter) {
+    size_t i;
     *max = arr[0];
     for(i = 1; (i < arr_length); ++i) {
         *instruction_counter += 2;
@@ -45,8 +80,8 @@ void find_max(const int arr[], const int arr_length, int *max, unsigned long lon
  * @param max a pointer to store the maximum value
  * @param instruction_counter pointer to the counter tracking the number of instructions
  */
-void find_min_max(const int arr[], const int arr_length, int *min, int *max, unsigned long long int *instruction_counter) {
-    int i;
+void find_min_max(const int arr[], const size_t arr_length, int *min, int *max, unsigned long long int *instruction_counter) {
+    size_t i;
     *min = arr[0];
     *max = *min;
     for(i = 1; (i < arr_length); ++i) {
@@ -73,19 +108,83 @@ int generate_random_number(const int min, const int max) {
     return ((((rand() & 0xff)<<8 | (rand() & 0xff))<<8 | (rand() & 0xff))<<7 | (rand() & 127)) % (max + 1 - min) + min;
 }
 
+/**
+ * Allocates a buffer for a large array. Buffers of at least HUGE_ALLOCATION_THRESHOLD bytes are aligned to
+ * HUGE_PAGE_SIZE and advised to use transparent huge pages, which keeps the random scatter of counting_key_sort from
+ * being dominated by TLB misses. The buffer is not touched, so every page is placed by the default first-touch policy on
+ * the node of the single thread that sorts in it. Smaller buffers come from malloc. Free with free().
+ * @param bytes the size of the buffer in bytes
+ * @return the allocated buffer, or NULL if the allocation failed
+ */
+void* huge_malloc(const size_t bytes) {
+    if (bytes < HUGE_ALLOCATION_THRESHOLD)
+        return malloc(bytes);
+
+    void *ptr = NULL;
+    size_t rounded_bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    if (posix_memalign(&ptr, HUGE_PAGE_SIZE, rounded_bytes))
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, rounded_bytes, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+/**
+ * Allocates a zeroed buffer for a large array, as huge_malloc does. Smaller buffers come from calloc. Free with free().
+ * @param count the number of elements
+ * @param size the size of each element in bytes
+ * @return the allocated buffer, or NULL if the allocation failed
+ */
+void* huge_calloc(const size_t count, const size_t size) {
+    if (size && count > SIZE_MAX / size)
+        return NULL;
+    if (count * size < HUGE_ALLOCATION_THRESHOLD)
+        return calloc(count, size);
+
+    void *ptr = huge_malloc(count * size);
+    if (ptr != NULL)
+        memset(ptr, 0, count * size);
+    return ptr;
+}
+
 /**
  * Ensures that the given array is sorted in ascending order.
  * @param arr the array to be tested
  * @param arr_length the length of the array
  * @return 0 if the array is not sorted, and 1 if the array is sorted
  */
-int is_sorted_ascending(const int arr[], const int arr_length) {
-    for (int i = 1; i < arr_length; ++i)
+int is_sorted_ascending(const int arr[], const size_t arr_length) {
+    for (size_t i = 1; i < arr_length; ++i)
         if (arr[i-1] > arr[i])
             return 0;
     return 1;
 }
 
+/**
+ * Loads instruction weights from a weights file, such as one written by the calibration mode. Each line holds a weight
+ * name followed by its value; lines starting with '#' and unknown names are ignored.
+ * @param weights_file the path of the weights file
+ * @return 1 if the file was read, and 0 if it could not be opened
+ */
+int load_instruction_weights(const char *weights_file) {
+    FILE *file = fopen(weights_file, "r");
+    if (file == NULL)
+        return 0;
+
+    char line[256], name[128];
+    double value;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || sscanf(line, "%127s %lf", name, &value) != 2)
+            continue;
+        for (int w = 0; w < INSTRUCTION_WEIGHT_COUNT; ++w)
+            if (!strcmp(name, instruction_weights[w].name))
+                *instruction_weights[w].weight = (value < 1) ? 1 : (int) (value + 0.5);
+    }
+    fclose(file);
+    return 1;
+}
+
 /**
  * Populates the given array with linearly spaced values in ascending order from the given minimum and maximum values.
  * @param arr the array to be populated
@@ -93,10 +192,10 @@ int is_sorted_ascending(const int arr[], const int arr_length) {
  * @param min the minimum array value; min < max
  * @param max the maximum array value; max > min
  */
-void lin_space(int arr[], const int arr_length, const int min, const int max) {
+void lin_space(int arr[], const size_t arr_length, const int min, const int max) {
     arr[0] = min;
     arr[arr_length - 1] = max;
-    for(int i = 1; i < arr_length - 1; ++i)
+    for(size_t i = 1; i + 1 < arr_length; ++i)
         arr[i] = (int) (i * ((max - min) / (double) arr_length)) + arr[0];
 }
 
@@ -105,24 +204,51 @@ void lin_space(int arr[], const int arr_length, const int min, const int max) {
  * @param arr the array to be printed
  * @param arr_length the length of the array
  */
-void print_int_array(const int arr[], const int arr_length) {
+void print_int_array(const int arr[], const size_t arr_length) {
     printf("[%d", arr[0]);
-    for (int i = 1; i < arr_length; ++i)
+    for (size_t i = 1; i < arr_length; ++i)
         printf(", %d", arr[i]);
     printf("]\n");
 }
 
+/**
+ * Reads one counter of a counting array whose counters are counter_size bytes wide.
+ * @param counting_arr the counting array
+ * @param counter_size the size of each counter in bytes, as given by COUNTER_SIZE
+ * @param index the index of the counter to read
+ * @return the value of the counter
+ */
+size_t read_counter(const void *counting_arr, const size_t counter_size, const size_t index) {
+    if (counter_size == sizeof(uint32_t))
+        return ((const uint32_t*) counting_arr)[index];
+    return ((const size_t*) counting_arr)[index];
+}
+
+/**
+ * Zeroes the first count counters of a counting array whose counters are counter_size bytes wide.
+ * @param counting_arr the counting array
+ * @param counter_size the size of each counter in bytes, as given by COUNTER_SIZE
+ * @param count the number of counters to zero
+ */
+void reset_counters(void *counting_arr, const size_t counter_size, const size_t count) {
+    memset(counting_arr, 0, count * counter_size);
+}
+
 /**
  * Given an int array and int array length, shuffle all the elements of the array with the Fisher-Yates algorithm which
  * produces an unbiased permutation.
  * @param arr the array to be shuffled
  * @param arr_length the length of the array
  */
-void shuffle(int arr[], const int arr_length) {
-    int random_index;
+void shuffle(int arr[], const size_t arr_length) {
+    size_t random_index;
     int tmp;
-    for(int i = arr_length - 1; i > 0; --i) {
-        random_index = generate_random_number(0, i);
+    for(size_t i = (arr_length > 0) ? arr_length - 1 : 0; i > 0; --i) {
+        // generate_random_number yields 31 random bits, so indices past INT_MAX combine two draws
+        if (i < INT_MAX)
+            random_index = generate_random_number(0, (int) i);
+        else
+            random_index = (((size_t) generate_random_number(0, INT_MAX - 1) << 31) | generate_random_number(0, INT_MAX - 1)) % (i + 1);
         tmp = arr[random_index];
         arr[random_index] = arr[i];
         arr[i] = tmp;
@@ -135,7 +261,7 @@ void shuffle(int arr[], const int arr_length) {
  * @param i the index of the first value to swap
  * @param j the index of the second value to swap
  */
-void swap(int arr[], const int i, const int j, unsigned long long int* instruction_counter) {
+void swap(int arr[], const size_t i, const size_t j, unsigned long long int* instruction_counter) {
     *instruction_counter += 4;
     int tmp = arr[i];
     arr[i] = arr[j];
@@ -6,26 +6,75 @@
 #ifndef SORT_TESTER_SORT_UTILS_H
 #define SORT_TESTER_SORT_UTILS_H
 
-#define DIVISION_INSTRUCTION_WEIGHT 15
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
 
-void clone_array(const int[], int[], int);
-void find_max(const int[], int, int*, unsigned long long int*);
-void find_min_max(const int[], int, int*, int*, unsigned long long int*);
+#define DEFAULT_COPY_INSTRUCTION_WEIGHT 3
+#define DEFAULT_KEY_INSTRUCTION_WEIGHT 3
+#define DEFAULT_DIVISION_INSTRUCTION_WEIGHT 15
+#define DEFAULT_SHIFT_KEY_INSTRUCTION_WEIGHT 4
+#define DEFAULT_HISTOGRAM_INSTRUCTION_WEIGHT 3
+#define DEFAULT_PREFIX_SUM_INSTRUCTION_WEIGHT 3
+#define DEFAULT_SCATTER_INSTRUCTION_WEIGHT 5
+#define DEFAULT_RESET_INSTRUCTION_WEIGHT 2
+#define COPY_INSTRUCTION_WEIGHT copy_instruction_weight  // Weighted instruction count of copying one element
+#define KEY_INSTRUCTION_WEIGHT key_instruction_weight  // Weighted instruction count of one division key, excluding the division
+#define DIVISION_INSTRUCTION_WEIGHT division_instruction_weight  // Weighted instruction count of one division or modulo
+#define SHIFT_KEY_INSTRUCTION_WEIGHT shift_key_instruction_weight  // Weighted instruction count of one bitwise key
+#define HISTOGRAM_INSTRUCTION_WEIGHT histogram_instruction_weight  // Weighted instruction count of counting one key
+#define PREFIX_SUM_INSTRUCTION_WEIGHT prefix_sum_instruction_weight  // Weighted instruction count of accumulating one counter
+#define SCATTER_INSTRUCTION_WEIGHT scatter_instruction_weight  // Weighted instruction count of placing one element by its key
+#define RESET_INSTRUCTION_WEIGHT reset_instruction_weight  // Weighted instruction count of zeroing one counter
+#define INSTRUCTION_WEIGHT_COUNT 8  // Number of instruction weights that can be loaded from a weights file
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)  // Size of a transparent huge page on x86-64 and most aarch64 kernels
+#define HUGE_ALLOCATION_THRESHOLD (4 * HUGE_PAGE_SIZE)  // Allocations smaller than this fall back to malloc/calloc
+
+#define COUNTER_SIZE(max_count) ((max_count) <= UINT32_MAX ? sizeof(uint32_t) : sizeof(size_t))  // Bytes per counting array counter holding up to max_count
+#define SORT_ALLOCATION_FAILED ULLONG_MAX  // Returned by a sort in place of its instruction count when its buffers could not be allocated
+
+typedef struct {
+    const char *name;  // The name of the weight in a weights file
+    int *weight;  // The global variable holding the weight
+} InstructionWeight;
+
+extern int copy_instruction_weight;
+extern int key_instruction_weight;
+extern int division_instruction_weight;
+extern int shift_key_instruction_weight;
+extern int histogram_instruction_weight;
+extern int prefix_sum_instruction_weight;
+extern int scatter_instruction_weight;
+extern int reset_instruction_weight;
+extern const InstructionWeight instruction_weights[INSTRUCTION_WEIGHT_COUNT];
+
+void clone_array(const int[], int[], size_t);
+double elapsed_ns(struct timespec);
+void find_max(const int[], size_t, int*, unsigned long long int*);
+void find_min_max(const int[], size_t, int*, int*, unsigned long long int*);
 int generate_random_number(int, int);
-int is_sorted_ascending(const int[], int);
-void lin_space(int[], int, int, int);
-void print_int_array(const int[], int);
-void shuffle(int[], int);
-void swap(int[], int, int, unsigned long long int*);
+void* huge_calloc(size_t, size_t);
+void* huge_malloc(size_t);
+int is_sorted_ascending(const int[], size_t);
+int load_instruction_weights(const char*);
+void lin_space(int[], size_t, int, int);
+void print_int_array(const int[], size_t);
+size_t read_counter(const void*, size_t, size_t);
+void reset_counters(void*, size_t, size_t);
+void shuffle(int[], size_t);
+void swap(int[], size_t, size_t, unsigned long long int*);
 
 typedef struct {
     int radix;  // Used in Radix Sort and specifies the divisor to use. If the user does not provide a positive value, default to array length.
     int divisor;  // Used in QR Sort and specifies the divisor to use. If the user does not provide a positive value, default to array length
     int min_value_zero;  // Flag indicating if the minimum value in the array is zero, optimizing Radix Sort and QR Sort.
     int bitwise_ops;  // Flag indicating if bitwise operations should be used, optimizing Radix Sort and QR Sort.
+    size_t rank;  // Used in selection and partial sorts and specifies the 1-based rank k. If the user does not provide a valid value, default to the median.
 } SortArgs;
 
 // Define the arguments needed for sorting algorithms
-typedef unsigned long long int (*SortFunc)(int[], int, SortArgs);
+typedef unsigned long long int (*SortFunc)(int[], size_t, SortArgs);
 
 #endif //SORT_TESTER_SORT_UTILS_H